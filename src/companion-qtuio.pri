@@ -10,12 +10,41 @@ CONFIG(debug, debug|release) {
 }
 
 HEADERS += $$PWD/qoscbundle_p.h \
+           $$PWD/qoscbundleview_p.h \
            $$PWD/qoscmessage_p.h \
+           $$PWD/qoscmessageview_p.h \
+           $$PWD/qoscpatternmatcher_p.h \
+           $$PWD/qoscsimd_p.h \
            $$PWD/qtuio_p.h \
+           $$PWD/qtuioclocksync_p.h \
            $$PWD/qtuiocursor_p.h \
+           $$PWD/qtuiodispatch_p.h \
+           $$PWD/qtuioframe.h \
+           $$PWD/qtuioframehistory_p.h \
+           $$PWD/qtuioframepool_p.h \
            $$PWD/qtuiotoken_p.h \
-           $$PWD/qtuiohandler.h
+           $$PWD/qtuiotriplebuffer_p.h \
+           $$PWD/qtuiohandler.h \
+           $$PWD/qtuiointerpolator_p.h \
+           $$PWD/qtuiojitterbuffer_p.h \
+           $$PWD/qtuiopredictor_p.h \
+           $$PWD/qtuiosessionfilter_p.h \
+           $$PWD/qtuiosessionset_p.h \
+           $$PWD/qtuiosetdecoder_p.h \
+           $$PWD/qtuioslotallocator_p.h \
+           $$PWD/qtuiosource_p.h \
+           $$PWD/qtuiospscring_p.h \
+           $$PWD/qudpbatchreceiver_p.h
            
 SOURCES += $$PWD/qoscbundle.cpp \
+           $$PWD/qoscbundleview.cpp \
            $$PWD/qoscmessage.cpp \
-           $$PWD/qtuiohandler.cpp
+           $$PWD/qoscmessageview.cpp \
+           $$PWD/qoscpatternmatcher.cpp \
+           $$PWD/qoscsimd.cpp \
+           $$PWD/qtuiohandler.cpp \
+           $$PWD/qtuiointerpolator.cpp \
+           $$PWD/qtuiojitterbuffer.cpp \
+           $$PWD/qtuiopredictor.cpp \
+           $$PWD/qtuiosessionfilter.cpp \
+           $$PWD/qudpbatchreceiver.cpp
@@ -27,8 +27,17 @@ SOURCES += \
     main_window.cpp \
     main.cpp \
     qoscbundle.cpp \
+    qoscbundleview.cpp \
     qoscmessage.cpp \
-    qtuiohandler.cpp
+    qoscmessageview.cpp \
+    qoscpatternmatcher.cpp \
+    qoscsimd.cpp \
+    qtuiohandler.cpp \
+    qtuiointerpolator.cpp \
+    qtuiojitterbuffer.cpp \
+    qtuiopredictor.cpp \
+    qtuiosessionfilter.cpp \
+    qudpbatchreceiver.cpp
 
 
 
@@ -36,9 +45,29 @@ HEADERS += \
     main_widget.h \
     main_window.h \
     qoscbundle_p.h \
+    qoscbundleview_p.h \
     qoscmessage_p.h \
+    qoscmessageview_p.h \
+    qoscpatternmatcher_p.h \
+    qoscsimd_p.h \
     qtuio_p.h \
+    qtuioclocksync_p.h \
     qtuiocursor_p.h \
+    qtuiodispatch_p.h \
+    qtuioframe.h \
+    qtuioframehistory_p.h \
+    qtuioframepool_p.h \
     qtuiohandler.h \
+    qtuiointerpolator_p.h \
+    qtuiojitterbuffer_p.h \
+    qtuiopredictor_p.h \
+    qtuiosessionfilter_p.h \
+    qtuiosessionset_p.h \
+    qtuiosetdecoder_p.h \
+    qtuioslotallocator_p.h \
+    qtuiosource_p.h \
+    qtuiospscring_p.h \
     qtuiotoken_p.h \
-    qtuioblob_p.h
+    qtuiotriplebuffer_p.h \
+    qtuioblob_p.h \
+    qudpbatchreceiver_p.h
@@ -19,7 +19,13 @@ MainWidget::MainWidget(QWidget *parent)
     , view_(0)
     , tuio_handler_(0)
 {
-    tuio_handler_ = new QTuioHandler(this);
+    // markers are moved as frames are emitted, so have them paced evenly,
+    // and skip frames piling up while the scene is busy redrawing
+    QTuioHandler::Options options;
+    options.jitterBuffer = true;
+    options.recycleFrames = true;
+    options.coalesceFrames = true;
+    tuio_handler_ = new QTuioHandler(QHostAddress::LocalHost, 3333, options, this);
 
     initWidgets();
     initLayout();
@@ -40,97 +46,80 @@ MainWidget::~MainWidget()
     }
 }
 
-void MainWidget::onCursorEvent(QMap<int, QTuioCursor> active_cursors, QVector<QTuioCursor> dead_cursors)
+// The item of the session in \a slot, null if there is none yet.
+template <typename Item>
+static Item *&itemAt(QVector<Item*> &items, int slot)
 {
+    if (slot >= items.size())
+        items.resize(slot + 1);
+    return items[slot];
+}
+
+// Takes the item of the session in \a slot out of \a scene.
+template <typename Item>
+static void removeItem(QGraphicsScene *scene, QVector<Item*> &items, int slot)
+{
+    if (slot < 0 || slot >= items.size() || !items[slot])
+        return;
+    scene->removeItem(items[slot]);
+    delete items[slot];
+    items[slot] = nullptr;
+}
+
+void MainWidget::onCursorEvent(const QVector<QTuioCursor> &active_cursors, const QVector<QTuioCursor> &dead_cursors)
+{
+    // remove all dead cursors first, a new cursor may have taken over the
+    // slot of one of them
+    for(const QTuioCursor &c: dead_cursors)
+        removeItem(scene_, marker_list_, c.slot());
+
     // add cursor
-    for(auto id: active_cursors.keys())
+    for(const QTuioCursor &cursor: active_cursors)
     {
-        QTuioCursor cursor = active_cursors[id];
-        if(!marker_list_.keys().contains(id)) {
-            auto marker = new QGraphicsEllipseItem(0,0,10,10);
-            marker->setX(width_ * (1-cursor.x()));
-            marker->setY(height_ * (1-cursor.y()));
-            marker_list_[id] = marker;
+        QGraphicsEllipseItem *&marker = itemAt(marker_list_, cursor.slot());
+        if(!marker) {
+            marker = new QGraphicsEllipseItem(0,0,10,10);
             scene_->addItem(marker);
-        } else {
-            marker_list_[id]->setX(width_ * (1-cursor.x()));
-            marker_list_[id]->setY(height_ * (1-cursor.y()));
-        }
-    }
-
-    // remove all dead cursors
-    for(QTuioCursor c: dead_cursors)
-    {
-        int id = c.id();
-        if(marker_list_.keys().contains(id)) {
-            scene_->removeItem(marker_list_[id]);
-            delete marker_list_[id];
-            marker_list_.remove(id);
         }
+        marker->setX(width_ * (1-cursor.x()));
+        marker->setY(height_ * (1-cursor.y()));
     }
 }
 
-void MainWidget::onTokenEvent(QMap<int, QTuioToken> active_token, QVector<QTuioToken> dead_token)
+void MainWidget::onTokenEvent(const QVector<QTuioToken> &active_token, const QVector<QTuioToken> &dead_token)
 {
-    for(auto id: active_token.keys()) {
+    for(const QTuioToken &t: dead_token)
+        removeItem(scene_, token_list_, t.slot());
 
-        QTuioToken token = active_token[id];
-        if(!token_list_.keys().contains(id)) {
-            auto marker = new QGraphicsRectItem(0,0,10,10);
+    for(const QTuioToken &token: active_token) {
+        QGraphicsRectItem *&marker = itemAt(token_list_, token.slot());
+        if(!marker) {
+            marker = new QGraphicsRectItem(0,0,10,10);
             marker->setBrush(QBrush(Qt::red));
-            marker->setX(width_ * (1-token.x()));
-            marker->setY(width_ * (1-token.y()));
-            marker->setRotation(qRadiansToDegrees(token.angle()));
-            token_list_[id] = marker;
             scene_->addItem(marker);
-        } else {
-            token_list_[id]->setX(width_ * (1-token.x()));
-            token_list_[id]->setY(width_ * (1-token.y()));
-            token_list_[id]->setRotation(qRadiansToDegrees(token.angle()));
         }
+        marker->setX(width_ * (1-token.x()));
+        marker->setY(width_ * (1-token.y()));
+        marker->setRotation(qRadiansToDegrees(token.angle()));
     }
-
-    for(QTuioToken t: dead_token) {
-        int id = t.id();
-        if(token_list_.keys().contains(id)) {
-            scene_->removeItem(token_list_[id]);
-            delete token_list_[id];
-            token_list_.remove(id);
-        }
-    }
-
 }
 
-void MainWidget::onBlobEvent(QMap<int, QTuioBlob> active_bobs, QVector<QTuioBlob> dead_bobs)
+void MainWidget::onBlobEvent(const QVector<QTuioBlob> &active_bobs, const QVector<QTuioBlob> &dead_bobs)
 {
-    for(auto id: active_bobs.keys()) {
+    for(const QTuioBlob &t: dead_bobs)
+        removeItem(scene_, blob_list_, t.slot());
 
-        QTuioBlob bob = active_bobs[id];
-        if(!blob_list_.keys().contains(id)) {
-            auto marker = new QGraphicsEllipseItem(0,0,bob.width() * width_ ,bob.height() * height_);
+    for(const QTuioBlob &bob: active_bobs) {
+        QGraphicsEllipseItem *&marker = itemAt(blob_list_, bob.slot());
+        if(!marker) {
+            marker = new QGraphicsEllipseItem(0,0,bob.width() * width_ ,bob.height() * height_);
             marker->setBrush(QBrush(Qt::blue));
-            marker->setX(width_ * (1-bob.x()));
-            marker->setY(width_ * (1-bob.y()));
-            marker->setRotation(qRadiansToDegrees(bob.angle()));
-            blob_list_[id] = marker;
             scene_->addItem(marker);
-        } else {
-            blob_list_[id]->setX(width_ * (1-bob.x()));
-            blob_list_[id]->setY(width_ * (1-bob.y()));
-            blob_list_[id]->setRotation(qRadiansToDegrees(bob.angle()));
         }
+        marker->setX(width_ * (1-bob.x()));
+        marker->setY(width_ * (1-bob.y()));
+        marker->setRotation(qRadiansToDegrees(bob.angle()));
     }
-
-    for(QTuioBlob t: dead_bobs) {
-        int id = t.id();
-        if(blob_list_.keys().contains(id)) {
-            scene_->removeItem(blob_list_[id]);
-            delete blob_list_[id];
-            blob_list_.remove(id);
-        }
-    }
-
-
 }
 
 void MainWidget::initWidgets()
@@ -4,7 +4,7 @@
 #include <QObject>
 #include <QWidget>
 
-#include <QMap>
+#include <QVector>
 
 #include <QGraphicsScene>
 #include <QGraphicsView>
@@ -24,9 +24,9 @@ class MainWidget : public QWidget
     signals:
 
     public slots:
-        void onCursorEvent(QMap<int, QTuioCursor> active_cursors, QVector<QTuioCursor> dead_cursors);
-        void onTokenEvent(QMap<int, QTuioToken> active_cursors, QVector<QTuioToken> dead_cursors);
-        void onBlobEvent(QMap<int, QTuioBlob> active_bobs, QVector<QTuioBlob> dead_bobs);
+        void onCursorEvent(const QVector<QTuioCursor> &active_cursors, const QVector<QTuioCursor> &dead_cursors);
+        void onTokenEvent(const QVector<QTuioToken> &active_cursors, const QVector<QTuioToken> &dead_cursors);
+        void onBlobEvent(const QVector<QTuioBlob> &active_bobs, const QVector<QTuioBlob> &dead_bobs);
 
     private:
         void initWidgets();
@@ -36,9 +36,10 @@ class MainWidget : public QWidget
         int width_;
         int height_;
 
-        QMap<int, QGraphicsEllipseItem*> marker_list_;
-        QMap<int, QGraphicsRectItem*> token_list_;
-        QMap<int, QGraphicsEllipseItem*> blob_list_;
+        // indexed by session slot
+        QVector<QGraphicsEllipseItem*> marker_list_;
+        QVector<QGraphicsRectItem*> token_list_;
+        QVector<QGraphicsEllipseItem*> blob_list_;
 
         QGraphicsScene *scene_;
         QGraphicsView *view_;
@@ -39,9 +39,7 @@
 ****************************************************************************/
 
 #include "qoscbundle_p.h"
-#include "qtuio_p.h"
 
-#include <QtEndian>
 #include <QDebug>
 #include <QLoggingCategory>
 
@@ -63,116 +61,71 @@ QOscBundle::QOscBundle(const QByteArray &data)
     , m_timeEpoch(0)
     , m_timePico(0)
 {
-    // 8  16 24 32 40 48 56 64
-    // #  b  u  n  d  l  e  \0
-    // 23 62 75 6e 64 6c 65 00 // OSC string bundle identifier
-    // 00 00 00 00 00 00 00 01 // osc time-tag, "immediately"
-    // 00 00 00 30 // element length
-    //      => message or bundle(s), preceded by length each time
-    qCDebug(lcTuioBundle) << data.toHex();
-    quint32 parsedBytes = 0;
+    init(data, QOscBundleView(data));
+}
 
-    // "An OSC Bundle consists of the OSC-string "#bundle""
-    QByteArray identifier;
-    if (!qt_readOscString(data, identifier, parsedBytes) || identifier != "#bundle")
-        return;
+// A nested bundle element; shares the datagram instead of copying the
+// element out of it.
+QOscBundle::QOscBundle(const QByteArray &data, quint32 offset, quint32 size)
+    : m_isValid(false)
+    , m_immediate(false)
+    , m_timeEpoch(0)
+    , m_timePico(0)
+{
+    init(data, QOscBundleView(data.constData() + offset, size));
+}
 
-    // "followed by an OSC Time
-    // Tag, followed by zero or more OSC Bundle Elements. The OSC-timetag is a
-    // 64-bit fixed point time tag whose semantics are described below."
-    if (parsedBytes > (quint32)data.size() || data.size() - parsedBytes < sizeof(quint64))
+void QOscBundle::init(const QByteArray &data, const QOscBundleView &view)
+{
+    qCDebug(lcTuioBundle) << QByteArray::fromRawData(view.data(), view.size()).toHex();
+    if (!view.isValid())
         return;
 
-    // "Time tags are represented by a 64 bit fixed point number. The first 32
-    // bits specify the number of seconds since midnight on January 1,  1900,
-    // and the last 32 bits specify fractional parts of a second to a precision
-    // of about 200 picoseconds. This is the representation used by Internet NTP
-    // timestamps."
-    //
-    // (editor's note: one may wonder how a 64bit big-endian number can also be
-    // two 32bit numbers, without specifying in which order they occur or
-    // anything, and one may indeed continue to wonder.)
-    quint32 oscTimeEpoch = qFromBigEndian<quint32>(data.constData() + parsedBytes);
-    parsedBytes += sizeof(quint32);
-    quint32 oscTimePico = qFromBigEndian<quint32>(data.constData() + parsedBytes);
-    parsedBytes += sizeof(quint32);
-
-    bool isImmediate = false;
-
-    if (oscTimeEpoch == 0 && oscTimePico == 1) {
-        // "The time tag value consisting of 63 zero bits followed by a
-        // one in the least signifigant bit is a special case meaning
-        // "immediately.""
-        isImmediate = true;
-    }
-
-    while (parsedBytes < (quint32)data.size()) {
-        // "An OSC Bundle Element consists of its size and its contents. The size is an
-        // int32 representing the number of 8-bit bytes in the contents, and will
-        // always be a multiple of 4."
-        //
-        // in practice, a bundle can contain multiple bundles or messages,
-        // though, and each is prefixed by a size.
-        if (data.size() - parsedBytes < sizeof(quint32))
-            return;
-
-        quint32 size = qFromBigEndian<quint32>((const uchar*)data.constData() + parsedBytes);
-        parsedBytes += sizeof(quint32);
-
-        if (data.size() - parsedBytes < size)
-            return;
-
-        if (size == 0) {
+    const quint32 base = quint32(view.data() - data.constData());
+    QOscBundleView::ElementIterator it = view.elements();
+    for (; !it.atEnd(); it.next()) {
+        if (it.size() == 0) {
             // empty bundle; these are valid, but should they be allowed? the
             // spec is unclear on this...
             qWarning("Empty bundle?");
             m_isValid = true;
-            m_immediate = isImmediate;
-            m_timeEpoch = oscTimeEpoch;
-            m_timePico = oscTimePico;
-            return;
+            break;
         }
 
-        // "The contents are either an OSC Message or an OSC Bundle.
-        // Note this recursive definition: bundle may contain bundles."
-        QByteArray subdata = data.mid(parsedBytes, size);
-        parsedBytes += size;
-
         // "The contents of an OSC packet must be either an OSC Message or an OSC Bundle.
         // The first byte of the packet's contents unambiguously distinguishes between
         // these two alternatives."
         //
         // we're not dealing with a packet here, but the same trick works just
         // the same.
-        QByteArray bundleIdentifier = QByteArray("#bundle\0",  8);
-        if (subdata.startsWith('/')) {
+        if (it.isMessage()) {
             // starts with / => address pattern => start of a message
-            QOscMessage subMessage(subdata);
+            QOscMessage subMessage(data, base + it.offset(), it.size());
             if (subMessage.isValid()) {
                 m_isValid = true;
-                m_immediate = isImmediate;
-                m_timeEpoch = oscTimeEpoch;
-                m_timePico = oscTimePico;
                 m_messages.append(subMessage);
             } else {
                 qWarning("Invalid sub-message");
-                return;
+                break;
             }
-        } else if (subdata.startsWith(bundleIdentifier)) {
+        } else if (it.isBundle()) {
             // bundle identifier start => bundle
-            QOscBundle subBundle(subdata);
+            QOscBundle subBundle(data, base + it.offset(), it.size());
             if (subBundle.isValid()) {
                 m_isValid = true;
-                m_immediate = isImmediate;
-                m_timeEpoch = oscTimeEpoch;
-                m_timePico = oscTimePico;
                 m_bundles.append(subBundle);
             }
         } else {
             qWarning("Malformed sub-data!");
-            return;
+            break;
         }
     }
+
+    if (m_isValid) {
+        m_immediate = view.isImmediate();
+        m_timeEpoch = view.timeEpoch();
+        m_timePico = view.timePico();
+    }
 }
 
 QT_END_NAMESPACE
@@ -42,6 +42,7 @@
 #define QOSCBUNDLE_P_H
 
 #include "qoscmessage_p.h"
+#include "qoscbundleview_p.h"
 
 #include <QtCore/QVector>
 
@@ -49,18 +50,33 @@ QT_BEGIN_NAMESPACE
 
 class QByteArray;
 
+/*!
+    \internal
+
+    An OSC bundle decoded up front into its nested bundles and messages,
+    each owning its storage. See QOscMessage: per datagram this allocates
+    once per element, so handling bundles as they come is done with a
+    QOscBundleView instead.
+*/
 class QOscBundle
 {
     QOscBundle(); // for QVector, don't use
     friend class QVector<QOscBundle>;
 public:
     explicit QOscBundle(const QByteArray &data);
+    QOscBundle(const QByteArray &data, quint32 offset, quint32 size);
 
     bool isValid() const { return m_isValid; }
+    bool isImmediate() const { return m_immediate; }
+    quint32 timeEpoch() const { return m_timeEpoch; }
+    quint32 timePico() const { return m_timePico; }
+    quint64 timeTag() const { return quint64(m_timeEpoch) << 32 | m_timePico; }
     QVector<QOscBundle> bundles() const { return m_bundles; }
     QVector<QOscMessage> messages() const { return m_messages; }
 
 private:
+    void init(const QByteArray &data, const QOscBundleView &view);
+
     bool m_isValid;
     bool m_immediate;
     quint32 m_timeEpoch;
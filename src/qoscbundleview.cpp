@@ -0,0 +1,117 @@
+#include "qoscbundleview_p.h"
+
+#include <QtEndian>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// TUIO packets are transmitted using the OSC protocol, located at:
+//   http://opensoundcontrol.org/specification
+// Snippets of this specification have been pasted into the source as a means of
+// easily communicating requirements.
+
+QOscBundleView::QOscBundleView(const char *data, quint32 size)
+    : m_data(data)
+    , m_size(size)
+    , m_elementsOffset(0)
+    , m_isValid(false)
+    , m_immediate(false)
+    , m_timeEpoch(0)
+    , m_timePico(0)
+{
+    // 8  16 24 32 40 48 56 64
+    // #  b  u  n  d  l  e  \0
+    // 23 62 75 6e 64 6c 65 00 // OSC string bundle identifier
+    // 00 00 00 00 00 00 00 01 // osc time-tag, "immediately"
+    // 00 00 00 30 // element length
+    //      => message or bundle(s), preceded by length each time
+
+    // "An OSC Bundle consists of the OSC-string "#bundle""
+    if (!isBundle(data, size))
+        return;
+    quint32 parsedBytes = 8;
+
+    // "followed by an OSC Time
+    // Tag, followed by zero or more OSC Bundle Elements. The OSC-timetag is a
+    // 64-bit fixed point time tag whose semantics are described below."
+    if (size - parsedBytes < sizeof(quint64))
+        return;
+
+    // "Time tags are represented by a 64 bit fixed point number. The first 32
+    // bits specify the number of seconds since midnight on January 1,  1900,
+    // and the last 32 bits specify fractional parts of a second to a precision
+    // of about 200 picoseconds. This is the representation used by Internet NTP
+    // timestamps."
+    //
+    // (editor's note: one may wonder how a 64bit big-endian number can also be
+    // two 32bit numbers, without specifying in which order they occur or
+    // anything, and one may indeed continue to wonder.)
+    m_timeEpoch = qFromBigEndian<quint32>(data + parsedBytes);
+    parsedBytes += sizeof(quint32);
+    m_timePico = qFromBigEndian<quint32>(data + parsedBytes);
+    parsedBytes += sizeof(quint32);
+
+    // "The time tag value consisting of 63 zero bits followed by a
+    // one in the least signifigant bit is a special case meaning
+    // "immediately.""
+    m_immediate = m_timeEpoch == 0 && m_timePico == 1;
+
+    m_elementsOffset = parsedBytes;
+    m_isValid = true;
+}
+
+bool QOscBundleView::isBundle(const char *data, quint32 size)
+{
+    return size >= 8 && memcmp(data, "#bundle\0", 8) == 0;
+}
+
+QOscBundleView::ElementIterator::ElementIterator(const QOscBundleView *view)
+    : m_view(view)
+    , m_offset(view->m_elementsOffset)
+    , m_elementSize(0)
+    , m_atEnd(!view->m_isValid)
+    , m_malformed(false)
+{
+    if (!m_atEnd)
+        locate(m_offset);
+}
+
+void QOscBundleView::ElementIterator::next()
+{
+    if (!m_atEnd)
+        locate(m_offset + m_elementSize);
+}
+
+void QOscBundleView::ElementIterator::locate(quint32 pos)
+{
+    const quint32 size = m_view->m_size;
+    if (pos >= size) {
+        m_atEnd = true;
+        return;
+    }
+
+    // "An OSC Bundle Element consists of its size and its contents. The size is an
+    // int32 representing the number of 8-bit bytes in the contents, and will
+    // always be a multiple of 4."
+    //
+    // in practice, a bundle can contain multiple bundles or messages,
+    // though, and each is prefixed by a size.
+    if (size - pos < sizeof(quint32)) {
+        m_atEnd = m_malformed = true;
+        return;
+    }
+
+    quint32 elementSize = qFromBigEndian<quint32>(m_view->m_data + pos);
+    pos += sizeof(quint32);
+
+    if (size - pos < elementSize) {
+        m_atEnd = m_malformed = true;
+        return;
+    }
+
+    m_offset = pos;
+    m_elementSize = elementSize;
+}
+
+QT_END_NAMESPACE
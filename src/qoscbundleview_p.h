@@ -0,0 +1,167 @@
+#ifndef QOSCBUNDLEVIEW_P_H
+#define QOSCBUNDLEVIEW_P_H
+
+#include "qoscmessageview_p.h"
+
+#include <QtCore/QByteArray>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    A non-owning view of an OSC bundle inside a datagram.
+
+    Bundle elements are walked in place with an ElementIterator; each element
+    is exposed as an offset and size into the original buffer, which must
+    outlive the view.
+*/
+class QOscBundleView
+{
+public:
+    QOscBundleView(const char *data, quint32 size);
+    explicit QOscBundleView(const QByteArray &data)
+        : QOscBundleView(data.constData(), data.size())
+    {
+    }
+
+    bool isValid() const { return m_isValid; }
+    bool isImmediate() const { return m_immediate; }
+    quint32 timeEpoch() const { return m_timeEpoch; }
+    quint32 timePico() const { return m_timePico; }
+    // the whole 64 bit NTP time tag, 1 meaning "immediately"
+    quint64 timeTag() const { return quint64(m_timeEpoch) << 32 | m_timePico; }
+
+    // converts an NTP time tag, counting from 1900, to nanoseconds since the
+    // Unix epoch
+    static qint64 toNsecsSinceEpoch(quint64 timeTag)
+    {
+        const qint64 secs = qint64(timeTag >> 32) - Q_INT64_C(2208988800);
+        return secs * 1000000000 + qint64(((timeTag & 0xffffffff) * 1000000000) >> 32);
+    }
+
+    const char *data() const { return m_data; }
+    quint32 size() const { return m_size; }
+
+    static bool isBundle(const char *data, quint32 size);
+    static bool isMessage(const char *data, quint32 size) { return size > 0 && data[0] == '/'; }
+
+    /*!
+        \internal
+
+        Walks the elements of a valid bundle. The iterator stops early, and
+        isMalformed() returns true, if an element size runs past the end of
+        the bundle.
+    */
+    class ElementIterator
+    {
+    public:
+        bool atEnd() const { return m_atEnd; }
+        bool isMalformed() const { return m_malformed; }
+        void next();
+
+        const char *data() const { return m_view->m_data + m_offset; }
+        quint32 offset() const { return m_offset; }
+        quint32 size() const { return m_elementSize; }
+
+        bool isMessage() const { return QOscBundleView::isMessage(data(), m_elementSize); }
+        bool isBundle() const { return QOscBundleView::isBundle(data(), m_elementSize); }
+
+    private:
+        friend class QOscBundleView;
+        explicit ElementIterator(const QOscBundleView *view);
+        void locate(quint32 pos);
+
+        const QOscBundleView *m_view;
+        quint32 m_offset;
+        quint32 m_elementSize;
+        bool m_atEnd;
+        bool m_malformed;
+    };
+
+    ElementIterator elements() const { return ElementIterator(this); }
+
+    template <typename Visitor>
+    static bool forEachMessage(const char *data, quint32 size, Visitor visitor);
+    template <typename Visitor>
+    static bool forEachMessage(const QByteArray &datagram, Visitor visitor)
+    {
+        return forEachMessage(datagram.constData(), datagram.size(), visitor);
+    }
+
+    // like forEachMessage(), but calls \a visitor with the raw bytes of every
+    // message, without parsing them. \a visitor returns false for a message
+    // it finds malformed.
+    template <typename Visitor>
+    static bool forEachMessageData(const char *data, quint32 size, Visitor visitor)
+    {
+        return visitPacket(data, size, visitor, 0);
+    }
+
+private:
+    // bundles nested deeper than this are dropped rather than recursed into
+    enum { MaxNestingDepth = 8 };
+
+    template <typename Visitor>
+    static bool visitPacket(const char *data, quint32 size, Visitor &visitor, int depth);
+
+    const char *m_data;
+    quint32 m_size;
+    quint32 m_elementsOffset;
+    bool m_isValid;
+    bool m_immediate;
+    quint32 m_timeEpoch;
+    quint32 m_timePico;
+};
+Q_DECLARE_TYPEINFO(QOscBundleView, Q_PRIMITIVE_TYPE);
+
+/*!
+    \internal
+
+    Calls \a visitor with a QOscMessageView for every message in the OSC
+    packet \a data, which is either a single message or a bundle. Nested
+    bundles are walked depth-first in place; no intermediate containers are
+    built.
+
+    Malformed elements are skipped. Returns false if anything in the packet
+    was malformed.
+*/
+template <typename Visitor>
+bool QOscBundleView::forEachMessage(const char *data, quint32 size, Visitor visitor)
+{
+    auto parse = [&visitor](const char *messageData, quint32 messageSize) {
+        QOscMessageView message(messageData, messageSize);
+        if (!message.isValid())
+            return false;
+        visitor(message);
+        return true;
+    };
+    return visitPacket(data, size, parse, 0);
+}
+
+template <typename Visitor>
+bool QOscBundleView::visitPacket(const char *data, quint32 size, Visitor &visitor, int depth)
+{
+    // "The contents of an OSC packet must be either an OSC Message or an OSC Bundle.
+    // The first byte of the packet's contents unambiguously distinguishes between
+    // these two alternatives."
+    if (isMessage(data, size))
+        return visitor(data, size);
+
+    QOscBundleView bundle(data, size);
+    if (!bundle.isValid() || depth >= MaxNestingDepth)
+        return false;
+
+    bool ok = true;
+    ElementIterator it = bundle.elements();
+    for (; !it.atEnd(); it.next()) {
+        // empty elements are valid, if pointless
+        if (it.size() != 0 && !visitPacket(it.data(), it.size(), visitor, depth + 1))
+            ok = false;
+    }
+    return ok && !it.isMalformed();
+}
+
+QT_END_NAMESPACE
+
+#endif // QOSCBUNDLEVIEW_P_H
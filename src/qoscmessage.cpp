@@ -39,10 +39,9 @@
 ****************************************************************************/
 
 #include "qoscmessage_p.h"
-#include "qtuio_p.h"
+#include "qoscsimd_p.h"
 
 #include <QDebug>
-#include <QtEndian>
 #include <QLoggingCategory>
 
 QT_BEGIN_NAMESPACE
@@ -51,78 +50,56 @@ Q_LOGGING_CATEGORY(lcTuioMessage, "qt.qpa.tuio.message")
 
 QOscMessage::QOscMessage() {}
 
-// TUIO packets are transmitted using the OSC protocol, located at:
-//   http://opensoundcontrol.org/specification
-// Snippets of this specification have been pasted into the source as a means of
-// easily communicating requirements.
-
 QOscMessage::QOscMessage(const QByteArray &data)
-    : m_isValid(false)
+    : m_data(data)
+    , m_view(m_data.constData(), m_data.size())
 {
-    qCDebug(lcTuioMessage) << data.toHex();
-    quint32 parsedBytes = 0;
-
-    // "An OSC message consists of an OSC Address Pattern"
-    QByteArray addressPattern;
-    if (!qt_readOscString(data, addressPattern, parsedBytes) || addressPattern.size() == 0)
-        return;
+    init();
+}
 
-    // "followed by an OSC Type Tag String"
-    QByteArray typeTagString;
-    if (!qt_readOscString(data, typeTagString, parsedBytes))
-        return;
+// A message element of a bundle; shares the bundle's datagram instead of
+// copying the element out of it.
+QOscMessage::QOscMessage(const QByteArray &data, quint32 offset, quint32 size)
+    : m_data(data)
+    , m_view(m_data.constData() + offset, size)
+{
+    init();
+}
 
-    // "Note: some older implementations of OSC may omit the OSC Type Tag string.
-    // Until all such implementations are updated, OSC implementations should be
-    // robust in the case of a missing OSC Type Tag String."
-    //
-    // (although, the editor notes one may question how exactly the hell one is
-    // supposed to be robust when the behavior is unspecified.)
-    if (typeTagString.size() == 0 || typeTagString.at(0) != ',')
+void QOscMessage::init()
+{
+    qCDebug(lcTuioMessage) << QByteArray::fromRawData(m_view.data(), m_view.size()).toHex();
+    if (!m_view.isValid())
         return;
 
-    QList<QVariant> arguments;
-
-    // "followed by zero or more OSC Arguments."
-    for (int i = 1; i < typeTagString.size(); ++i) {
-        char typeTag = typeTagString.at(i);
-        if (typeTag == 's') { // osc-string
-            QByteArray aString;
-            if (!qt_readOscString(data, aString, parsedBytes))
-                return;
-            arguments.append(aString);
-        } else if (typeTag == 'i') { // int32
-            if (parsedBytes > (quint32)data.size() || data.size() - parsedBytes < sizeof(quint32))
-                return;
-
-            quint32 anInt = qFromBigEndian<quint32>(data.constData() + parsedBytes);
-            parsedBytes += sizeof(quint32);
-
-            // TODO: is int32 in OSC signed, or unsigned?
-            arguments.append((int)anInt);
-        } else if (typeTag == 'f') { // float32
-            if (parsedBytes > (quint32)data.size() || data.size() - parsedBytes < sizeof(quint32))
-                return;
-
-            Q_STATIC_ASSERT(sizeof(float) == sizeof(quint32));
-            union {
-                quint32 u;
-                float f;
-            } value;
-            value.u = qFromBigEndian<quint32>(data.constData() + parsedBytes);
-            parsedBytes += sizeof(quint32);
-            arguments.append(value.f);
-        } else {
-            qWarning() << "Reading argument of unknown type " << typeTag;
-            return;
+    m_arguments.resize(m_view.argumentCount());
+    QOscArgument *arg = m_arguments.data();
+
+    QOscMessageView::ArgumentIterator it = m_view.arguments();
+    while (!it.atEnd()) {
+        if (it.type() == 's') {
+            arg->type = 's';
+            arg->value.s.offset = it.offset();
+            arg->value.s.size = it.toString().size();
+            ++arg;
+            it.next();
+            continue;
         }
-    }
 
-    m_isValid = true;
-    m_addressPattern = addressPattern;
-    m_arguments = arguments;
+        // consecutive int32 and float32 arguments are contiguous words in
+        // the datagram, convert the whole run at once
+        const char *run = m_view.data() + it.offset();
+        quint32 words[16];
+        int count = 0;
+        for (; !it.atEnd() && it.type() != 's' && count < 16; it.next())
+            arg[count++].type = it.type();
+
+        qt_oscWordsFromBigEndian(run, words, count);
+        for (int i = 0; i < count; ++i, ++arg)
+            arg->value.i = qint32(words[i]);
+    }
 
-    qCDebug(lcTuioMessage) << "Message with address pattern: " << addressPattern << " arguments: " << arguments;
+    qCDebug(lcTuioMessage) << "Message with address pattern: " << m_view.addressPattern() << " type tags: " << m_view.typeTags();
 }
 
 QT_END_NAMESPACE
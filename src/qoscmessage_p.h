@@ -41,30 +41,74 @@
 #ifndef QOSCMESSAGE_P_H
 #define QOSCMESSAGE_P_H
 
+#include "qoscmessageview_p.h"
+
 #include <QtCore/QByteArray>
-#include <QtCore/QVariant>
 #include <QtCore/QVector>
-#include <QtCore/QList>
 
 
 QT_BEGIN_NAMESPACE
 
+/*!
+    \internal
+
+    One decoded OSC argument: its type tag and a 4 or 8 byte payload, already
+    converted to host byte order. Strings are kept in place and referenced by
+    their offset and size relative to the start of the message.
+*/
+struct QOscArgument
+{
+    char type;
+    union {
+        qint32 i;
+        float f;
+        struct {
+            quint32 offset;
+            quint32 size;
+        } s;
+    } value;
+};
+Q_DECLARE_TYPEINFO(QOscArgument, Q_PRIMITIVE_TYPE);
+
+/*!
+    \internal
+
+    An OSC message decoded up front, for code that keeps messages around.
+    It shares the datagram and allocates an argument array of its own, so
+    building one per message costs an allocation or two. Code that handles
+    messages as they come, like QTuioHandler, walks a QOscMessageView over
+    the datagram instead, which allocates nothing.
+*/
 class QOscMessage
 {
     QOscMessage(); // for QVector, don't use
     friend class QVector<QOscMessage>;
 public:
     explicit QOscMessage(const QByteArray &data);
+    QOscMessage(const QByteArray &data, quint32 offset, quint32 size);
 
-    bool isValid() const { return m_isValid; }
+    bool isValid() const { return m_view.isValid(); }
+    const QOscMessageView &view() const { return m_view; }
 
-    QByteArray addressPattern() const { return m_addressPattern; }
-    QList<QVariant> arguments() const { return m_arguments; }
+    QLatin1String addressPattern() const { return m_view.addressPattern(); }
+    QLatin1String typeTags() const { return m_view.typeTags(); }
+
+    int argumentCount() const { return m_arguments.size(); }
+    char typeAt(int i) const { return m_arguments.at(i).type; }
+    qint32 intAt(int i) const { return m_arguments.at(i).value.i; }
+    float floatAt(int i) const { return m_arguments.at(i).value.f; }
+    QLatin1String stringAt(int i) const
+    {
+        const QOscArgument &arg = m_arguments.at(i);
+        return QLatin1String(m_view.data() + arg.value.s.offset, arg.value.s.size);
+    }
 
 private:
-    bool m_isValid;
-    QByteArray m_addressPattern;
-    QList<QVariant> m_arguments;
+    void init();
+
+    QByteArray m_data; // shared with the datagram, keeps m_view alive
+    QOscMessageView m_view;
+    QVector<QOscArgument> m_arguments;
 };
 Q_DECLARE_TYPEINFO(QOscMessage, Q_MOVABLE_TYPE);
 
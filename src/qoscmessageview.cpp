@@ -0,0 +1,146 @@
+#include "qoscmessageview_p.h"
+#include "qtuio_p.h"
+
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+// TUIO packets are transmitted using the OSC protocol, located at:
+//   http://opensoundcontrol.org/specification
+// Snippets of this specification have been pasted into the source as a means of
+// easily communicating requirements.
+
+QOscMessageView::QOscMessageView(const char *data, quint32 size)
+    : m_data(data)
+    , m_size(size)
+    , m_addressLength(0)
+    , m_typeTagsOffset(0)
+    , m_typeTagsLength(0)
+    , m_argumentsOffset(0)
+    , m_isValid(false)
+{
+    quint32 parsedBytes = 0;
+
+    // "An OSC message consists of an OSC Address Pattern"
+    quint32 addressLength = 0;
+    if (!qt_scanOscString(data, size, parsedBytes, addressLength) || addressLength == 0)
+        return;
+
+    // "followed by an OSC Type Tag String"
+    quint32 typeTagsOffset = parsedBytes;
+    quint32 typeTagsLength = 0;
+    if (!qt_scanOscString(data, size, parsedBytes, typeTagsLength))
+        return;
+
+    // "Note: some older implementations of OSC may omit the OSC Type Tag string.
+    // Until all such implementations are updated, OSC implementations should be
+    // robust in the case of a missing OSC Type Tag String."
+    //
+    // (although, the editor notes one may question how exactly the hell one is
+    // supposed to be robust when the behavior is unspecified.)
+    if (typeTagsLength == 0 || data[typeTagsOffset] != ',')
+        return;
+
+    quint32 argumentsOffset = parsedBytes;
+
+    // "followed by zero or more OSC Arguments."
+    for (quint32 i = 1; i < typeTagsLength; ++i) {
+        char typeTag = data[typeTagsOffset + i];
+        if (typeTag == 's') { // osc-string
+            quint32 length = 0;
+            if (!qt_scanOscString(data, size, parsedBytes, length))
+                return;
+        } else if (typeTag == 'i' || typeTag == 'f') { // int32, float32
+            if (parsedBytes > size || size - parsedBytes < sizeof(quint32))
+                return;
+            parsedBytes += sizeof(quint32);
+        } else {
+            qWarning() << "Reading argument of unknown type " << typeTag;
+            return;
+        }
+    }
+
+    m_addressLength = addressLength;
+    m_typeTagsOffset = typeTagsOffset;
+    m_typeTagsLength = typeTagsLength;
+    m_argumentsOffset = argumentsOffset;
+    m_isValid = true;
+}
+
+quint32 QOscMessageView::argumentOffset(int i) const
+{
+    quint32 offset = m_argumentsOffset;
+    for (int n = 0; n < i; ++n) {
+        if (typeAt(n) == 's') {
+            quint32 length = 0;
+            qt_scanOscString(m_data, m_size, offset, length);
+        } else {
+            offset += sizeof(quint32);
+        }
+    }
+    return offset;
+}
+
+qint32 QOscMessageView::intAt(int i) const
+{
+    return qt_readOscInt(m_data + argumentOffset(i));
+}
+
+float QOscMessageView::floatAt(int i) const
+{
+    return qt_readOscFloat(m_data + argumentOffset(i));
+}
+
+QLatin1String QOscMessageView::stringAt(int i) const
+{
+    const char *string = m_data + argumentOffset(i);
+    return QLatin1String(string, int(qstrlen(string)));
+}
+
+void QOscMessageView::wordsAt(int first, int count, quint32 *words) const
+{
+    qt_oscWordsFromBigEndian(m_data + argumentOffset(first), words, count);
+}
+
+QOscMessageView::ArgumentIterator::ArgumentIterator(const QOscMessageView *view)
+    : m_view(view)
+    , m_index(0)
+    , m_offset(view->m_argumentsOffset)
+    , m_length(0)
+    , m_next(view->m_argumentsOffset)
+{
+    locate();
+}
+
+void QOscMessageView::ArgumentIterator::next()
+{
+    ++m_index;
+    m_offset = m_next;
+    locate();
+}
+
+void QOscMessageView::ArgumentIterator::locate()
+{
+    if (atEnd())
+        return;
+
+    if (type() == 's') {
+        qt_scanOscString(m_view->m_data, m_view->m_size, m_next, m_length);
+    } else {
+        m_length = sizeof(quint32);
+        m_next += sizeof(quint32);
+    }
+}
+
+qint32 QOscMessageView::ArgumentIterator::toInt() const
+{
+    // TODO: is int32 in OSC signed, or unsigned?
+    return qt_readOscInt(m_view->m_data + m_offset);
+}
+
+float QOscMessageView::ArgumentIterator::toFloat() const
+{
+    return qt_readOscFloat(m_view->m_data + m_offset);
+}
+
+QT_END_NAMESPACE
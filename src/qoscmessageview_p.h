@@ -0,0 +1,115 @@
+#ifndef QOSCMESSAGEVIEW_P_H
+#define QOSCMESSAGEVIEW_P_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLatin1String>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    A non-owning view of an OSC message inside a datagram.
+
+    The address pattern, the type tag string and the arguments are exposed as
+    offsets into the original buffer, nothing is copied. The buffer must
+    outlive the view.
+*/
+class QOscMessageView
+{
+public:
+    QOscMessageView()
+        : m_data(nullptr)
+        , m_size(0)
+        , m_addressLength(0)
+        , m_typeTagsOffset(0)
+        , m_typeTagsLength(0)
+        , m_argumentsOffset(0)
+        , m_isValid(false)
+    {
+    }
+
+    QOscMessageView(const char *data, quint32 size);
+    explicit QOscMessageView(const QByteArray &data)
+        : QOscMessageView(data.constData(), data.size())
+    {
+    }
+
+    bool isValid() const { return m_isValid; }
+
+    const char *data() const { return m_data; }
+    quint32 size() const { return m_size; }
+
+    QLatin1String addressPattern() const { return QLatin1String(m_data, m_addressLength); }
+
+    // type tags of the arguments, without the leading ','
+    QLatin1String typeTags() const
+    {
+        return m_isValid ? QLatin1String(m_data + m_typeTagsOffset + 1, m_typeTagsLength - 1)
+                         : QLatin1String();
+    }
+
+    int argumentCount() const { return m_isValid ? int(m_typeTagsLength) - 1 : 0; }
+    char typeAt(int i) const { return m_data[m_typeTagsOffset + 1 + i]; }
+    quint32 argumentsOffset() const { return m_argumentsOffset; }
+
+    // Random access to the arguments of a valid message; \a i must be in
+    // range and of the type asked for. Locating an argument scans the
+    // strings before it, so walk messages with many strings with an
+    // ArgumentIterator instead.
+    quint32 argumentOffset(int i) const;
+    qint32 intAt(int i) const;
+    float floatAt(int i) const;
+    QLatin1String stringAt(int i) const;
+    // converts the \a count int32 or float32 arguments from \a first on,
+    // one run of words in the datagram, to host byte order in one go
+    void wordsAt(int first, int count, quint32 *words) const;
+
+    /*!
+        \internal
+
+        Walks the arguments of a valid message in order. Strings are located
+        in place as the iterator reaches them.
+    */
+    class ArgumentIterator
+    {
+    public:
+        bool atEnd() const { return m_index >= m_view->argumentCount(); }
+        void next();
+
+        int index() const { return m_index; }
+        char type() const { return m_view->typeAt(m_index); }
+        quint32 offset() const { return m_offset; }
+
+        qint32 toInt() const;
+        float toFloat() const;
+        QLatin1String toString() const { return QLatin1String(m_view->m_data + m_offset, m_length); }
+
+    private:
+        friend class QOscMessageView;
+        explicit ArgumentIterator(const QOscMessageView *view);
+        void locate();
+
+        const QOscMessageView *m_view;
+        int m_index;
+        quint32 m_offset;
+        quint32 m_length;
+        quint32 m_next;
+    };
+
+    ArgumentIterator arguments() const { return ArgumentIterator(this); }
+
+private:
+    const char *m_data;
+    quint32 m_size;
+    quint32 m_addressLength;
+    quint32 m_typeTagsOffset;
+    quint32 m_typeTagsLength;
+    quint32 m_argumentsOffset;
+    bool m_isValid;
+};
+Q_DECLARE_TYPEINFO(QOscMessageView, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QOSCMESSAGEVIEW_P_H
@@ -0,0 +1,248 @@
+#include "qoscpatternmatcher_p.h"
+
+#include <QHash>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// OSC address pattern matching, as described in:
+//   http://opensoundcontrol.org/spec-1_0
+// "When an OSC server receives an OSC Message, it must invoke the appropriate
+// OSC Methods in its OSC Address Space based on the OSC Message's OSC Address
+// Pattern. This process is called dispatching."
+
+QOscPatternMatcher::QOscPatternMatcher(const QByteArray &pattern)
+    : m_pattern(pattern)
+    , m_isValid(false)
+{
+    int pos = 0;
+    const int size = pattern.size();
+    while (pos < size) {
+        const char c = pattern.at(pos);
+        if (c == '?') {
+            // "'?' in the OSC Address Pattern matches any single character"
+            Token token = { AnyCharacter, pos++, 1 };
+            m_tokens.append(token);
+        } else if (c == '*') {
+            // "'*' in the OSC Address Pattern matches any sequence of zero or
+            // more characters"
+            while (pos < size && pattern.at(pos) == '*')
+                ++pos;
+            Token token = { AnySequence, pos, 0 };
+            m_tokens.append(token);
+        } else if (c == '[') {
+            // "A string of characters in square brackets (e.g., "[string]")
+            // in the OSC Address Pattern matches any character in the string."
+            if (!compileClass(pos))
+                return;
+        } else if (c == '{') {
+            // "A comma-separated list of strings enclosed in curly braces
+            // (e.g., "{foo,bar}") in the OSC Address Pattern matches any of
+            // the strings in the list."
+            int end = pattern.indexOf('}', pos);
+            if (end < 0)
+                return;
+            Token token = { Alternatives, pos + 1, end - pos - 1 };
+            m_tokens.append(token);
+            pos = end + 1;
+        } else if (c == ']' || c == '}') {
+            return;
+        } else {
+            int start = pos;
+            while (pos < size && !memchr("?*[]{}", pattern.at(pos), 6))
+                ++pos;
+            Token token = { Literal, start, pos - start };
+            m_tokens.append(token);
+        }
+    }
+
+    m_isValid = size > 0 && pattern.at(0) == '/';
+}
+
+bool QOscPatternMatcher::compileClass(int &pos)
+{
+    const int end = m_pattern.indexOf(']', pos + 1);
+    if (end < 0)
+        return false;
+
+    int i = pos + 1;
+    // "An exclamation point at the beginning of a bracketed string negates
+    // the sense of the list"
+    const bool negated = i < end && m_pattern.at(i) == '!';
+    if (negated)
+        ++i;
+
+    const int offset = m_classes.size();
+    m_classes.resize(offset + 8);
+    quint32 *bits = m_classes.data() + offset;
+    for (; i < end; ++i) {
+        uchar first = uchar(m_pattern.at(i));
+        uchar last = first;
+        // "two characters separated by a minus sign indicate the string of
+        // characters between the given two in ASCII collating sequence. (A
+        // minus sign at the end of the string has no special meaning.)"
+        if (i + 2 < end && m_pattern.at(i + 1) == '-') {
+            last = uchar(m_pattern.at(i + 2));
+            i += 2;
+        }
+        for (int ch = first; ch <= last; ++ch)
+            bits[ch / 32] |= 1u << (ch % 32);
+    }
+
+    if (negated) {
+        for (int word = 0; word < 8; ++word)
+            bits[word] = ~bits[word];
+    }
+    bits['/' / 32] &= ~(1u << ('/' % 32));
+
+    Token token = { CharacterClass, offset, 8 };
+    m_tokens.append(token);
+    pos = end + 1;
+    return true;
+}
+
+bool QOscPatternMatcher::matches(QLatin1String address) const
+{
+    return m_isValid && matchFrom(0, address.data(), address.size());
+}
+
+bool QOscPatternMatcher::matchFrom(int index, const char *address, int length) const
+{
+    for (; index < m_tokens.size(); ++index) {
+        const Token &token = m_tokens.at(index);
+        switch (token.type) {
+        case Literal:
+            if (length < token.length || memcmp(address, m_pattern.constData() + token.offset, token.length) != 0)
+                return false;
+            address += token.length;
+            length -= token.length;
+            break;
+        case AnyCharacter:
+            if (length == 0 || *address == '/')
+                return false;
+            ++address;
+            --length;
+            break;
+        case CharacterClass: {
+            if (length == 0)
+                return false;
+            const uchar ch = uchar(*address);
+            if (!(m_classes.at(token.offset + ch / 32) & (1u << (ch % 32))))
+                return false;
+            ++address;
+            --length;
+            break;
+        }
+        case AnySequence:
+            // try every split up to the end of this part of the address
+            for (int skip = 0; skip <= length; ++skip) {
+                if (matchFrom(index + 1, address + skip, length - skip))
+                    return true;
+                if (skip < length && address[skip] == '/')
+                    break;
+            }
+            return false;
+        case Alternatives: {
+            const char *list = m_pattern.constData() + token.offset;
+            const char *listEnd = list + token.length;
+            while (list <= listEnd) {
+                const char *comma = static_cast<const char *>(memchr(list, ',', listEnd - list));
+                const int altLength = int((comma ? comma : listEnd) - list);
+                if (altLength <= length && memcmp(address, list, altLength) == 0
+                        && matchFrom(index + 1, address + altLength, length - altLength))
+                    return true;
+                list += altLength + 1;
+            }
+            return false;
+        }
+        }
+    }
+
+    return length == 0;
+}
+
+QOscPatternDispatcher::QOscPatternDispatcher()
+    : m_cache(CacheSize)
+    , m_cachedAddresses(0)
+    , m_nextId(0)
+{
+}
+
+int QOscPatternDispatcher::addHandler(const QByteArray &pattern, const Handler &handler)
+{
+    QOscPatternMatcher matcher(pattern);
+    if (!matcher.isValid() || !handler)
+        return -1;
+
+    Route route = { m_nextId++, matcher, handler };
+    m_routes.append(route);
+    clearCache();
+    return route.id;
+}
+
+bool QOscPatternDispatcher::removeHandler(int id)
+{
+    for (int i = 0; i < m_routes.size(); ++i) {
+        if (m_routes.at(i).id == id) {
+            m_routes.remove(i);
+            clearCache();
+            return true;
+        }
+    }
+    return false;
+}
+
+QOscPatternDispatcher::Match QOscPatternDispatcher::match(QLatin1String address)
+{
+    Match match;
+    if (m_routes.isEmpty())
+        return match;
+
+    match.m_indices = resolve(address).routes;
+    if (!match.m_indices.isEmpty())
+        match.m_routes = m_routes;
+    return match;
+}
+
+const QOscPatternDispatcher::CacheEntry &QOscPatternDispatcher::resolve(QLatin1String address)
+{
+    const uint hash = qHashBits(address.data(), address.size());
+    int slot = hash & (CacheSize - 1);
+    for (;; slot = (slot + 1) & (CacheSize - 1)) {
+        const CacheEntry &entry = m_cache.at(slot);
+        if (entry.address.isEmpty())
+            break;
+        if (entry.hash == hash && QLatin1String(entry.address) == address)
+            return entry;
+    }
+
+    // first time we see this address: match it against every pattern once.
+    // A sender cycling through random addresses must not grow the cache
+    // without bound, so start over once it fills up.
+    if (m_cachedAddresses >= MaxCachedAddresses) {
+        clearCache();
+        slot = hash & (CacheSize - 1);
+    }
+
+    CacheEntry &entry = m_cache[slot];
+    entry.hash = hash;
+    entry.address = QByteArray(address.data(), address.size());
+    for (int i = 0; i < m_routes.size(); ++i) {
+        if (m_routes.at(i).matcher.matches(address))
+            entry.routes.append(i);
+    }
+    ++m_cachedAddresses;
+    return entry;
+}
+
+void QOscPatternDispatcher::clearCache()
+{
+    for (CacheEntry &entry : m_cache) {
+        entry.address.clear();
+        entry.routes.clear();
+    }
+    m_cachedAddresses = 0;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,138 @@
+#ifndef QOSCPATTERNMATCHER_P_H
+#define QOSCPATTERNMATCHER_P_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLatin1String>
+#include <QtCore/QVector>
+
+#include <functional>
+
+#include "qoscmessageview_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    An OSC 1.0 address pattern, compiled once into a list of tokens.
+
+    Supports '?' (any single character), '*' (any sequence of characters),
+    '[a-z]' and '[!a-z]' (character classes) and '{foo,bar}' (alternatives).
+    Like most OSC implementations, '?' and '*' never match a '/', so they
+    stay within one part of the address.
+*/
+class QOscPatternMatcher
+{
+public:
+    QOscPatternMatcher() : m_isValid(false) {}
+    explicit QOscPatternMatcher(const QByteArray &pattern);
+
+    bool isValid() const { return m_isValid; }
+    QByteArray pattern() const { return m_pattern; }
+
+    bool matches(QLatin1String address) const;
+
+private:
+    enum TokenType {
+        Literal,
+        AnyCharacter,
+        AnySequence,
+        CharacterClass,
+        Alternatives
+    };
+
+    struct Token
+    {
+        TokenType type;
+        int offset; // into m_pattern, or m_classes for CharacterClass
+        int length;
+    };
+
+    bool matchFrom(int token, const char *address, int length) const;
+    bool compileClass(int &pos);
+
+    QByteArray m_pattern;
+    QVector<Token> m_tokens;
+    QVector<quint32> m_classes; // 256 bit set per character class
+    bool m_isValid;
+};
+
+/*!
+    \internal
+
+    Routes OSC messages to handlers registered by address pattern.
+
+    Matching every pattern against every message would be wasteful, since a
+    tracker only ever sends a handful of distinct addresses. The routes
+    matching an address are resolved on first sight and cached, so in steady
+    state dispatch is a single hash lookup.
+
+    The routes are implicitly shared, so match() hands out a snapshot of
+    them without copying: the caller can call the handlers after letting go
+    of whatever lock guards the dispatcher, and the handlers can add or
+    remove routes meanwhile, taking effect from the next match().
+*/
+class QOscPatternDispatcher
+{
+public:
+    typedef std::function<void(const QOscMessageView &)> Handler;
+
+private:
+    struct Route
+    {
+        int id;
+        QOscPatternMatcher matcher;
+        Handler handler;
+    };
+
+public:
+    // the handlers matching one address, as of the match() that returned it
+    class Match
+    {
+    public:
+        bool isEmpty() const { return m_indices.isEmpty(); }
+        void dispatch(const QOscMessageView &message) const
+        {
+            for (int index : m_indices)
+                m_routes.at(index).handler(message);
+        }
+
+    private:
+        friend class QOscPatternDispatcher;
+        QVector<Route> m_routes;
+        QVector<int> m_indices; // into m_routes
+    };
+
+    QOscPatternDispatcher();
+
+    bool isEmpty() const { return m_routes.isEmpty(); }
+
+    // returns an ID for removeHandler(), or -1 if the pattern is malformed
+    int addHandler(const QByteArray &pattern, const Handler &handler);
+    // returns false if there was no handler \a id
+    bool removeHandler(int id);
+
+    Match match(QLatin1String address);
+
+private:
+    struct CacheEntry
+    {
+        uint hash;
+        QByteArray address;
+        QVector<int> routes; // indices into m_routes
+    };
+
+    const CacheEntry &resolve(QLatin1String address);
+    void clearCache();
+
+    enum { CacheSize = 64, MaxCachedAddresses = 48 };
+
+    QVector<Route> m_routes;
+    QVector<CacheEntry> m_cache; // open addressing, linear probing
+    int m_cachedAddresses;
+    int m_nextId;
+};
+
+QT_END_NAMESPACE
+
+#endif // QOSCPATTERNMATCHER_P_H
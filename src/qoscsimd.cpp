@@ -0,0 +1,197 @@
+#include "qoscsimd_p.h"
+
+#include <QtEndian>
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define QOSC_HAVE_SSE2
+#  include <emmintrin.h>
+#  if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#    define QOSC_HAVE_AVX2
+#    include <immintrin.h>
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define QOSC_HAVE_NEON
+#  include <arm_neon.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+typedef int (*FindNulFunction)(const char *, quint32, quint32);
+typedef void (*FromBigEndianFunction)(const char *, quint32 *, int);
+
+inline int countTrailingZeros(quint32 mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int n = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+int findNulScalar(const char *data, quint32 from, quint32 size)
+{
+    if (from >= size)
+        return -1;
+    const char *end = static_cast<const char *>(memchr(data + from, '\0', size - from));
+    return end ? int(end - data) : -1;
+}
+
+void fromBigEndianScalar(const char *src, quint32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i)
+        dst[i] = qFromBigEndian<quint32>(src + 4 * i);
+}
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+
+void fromBigEndianCopy(const char *src, quint32 *dst, int count)
+{
+    memcpy(dst, src, 4 * count);
+}
+
+#else
+
+#if defined(QOSC_HAVE_SSE2)
+
+int findNulSse2(const char *data, quint32 from, quint32 size)
+{
+    const __m128i zero = _mm_setzero_si128();
+    quint32 i = from;
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        quint32 mask = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)));
+        if (mask)
+            return int(i + countTrailingZeros(mask));
+    }
+    return findNulScalar(data, i, size);
+}
+
+void fromBigEndianSse2(const char *src, quint32 *dst, int count)
+{
+    // no pshufb before SSSE3: swap the bytes within each 16 bit half, then
+    // swap the halves
+    const __m128i lowBytes = _mm_set1_epi16(0x00ff);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4 * i));
+        v = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 8), lowBytes),
+                         _mm_slli_epi16(_mm_and_si128(v, lowBytes), 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+    }
+    fromBigEndianScalar(src + 4 * i, dst + i, count - i);
+}
+
+#endif // QOSC_HAVE_SSE2
+
+#if defined(QOSC_HAVE_AVX2)
+
+__attribute__((target("avx2")))
+int findNulAvx2(const char *data, quint32 from, quint32 size)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    quint32 i = from;
+    for (; i + 32 <= size; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        quint32 mask = quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, zero)));
+        if (mask)
+            return int(i + countTrailingZeros(mask));
+    }
+    return findNulSse2(data, i, size);
+}
+
+__attribute__((target("avx2")))
+void fromBigEndianAvx2(const char *src, quint32 *dst, int count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                             3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 4 * i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_shuffle_epi8(v, shuffle));
+    }
+    fromBigEndianSse2(src + 4 * i, dst + i, count - i);
+}
+
+#endif // QOSC_HAVE_AVX2
+
+#if defined(QOSC_HAVE_NEON)
+
+int findNulNeon(const char *data, quint32 from, quint32 size)
+{
+    quint32 i = from;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(data + i)), vdupq_n_u8(0));
+        // narrow each byte of the comparison to a nibble to get a 64 bit mask
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (mask)
+            return int(i + __builtin_ctzll(mask) / 4);
+    }
+    return findNulScalar(data, i, size);
+}
+
+void fromBigEndianNeon(const char *src, quint32 *dst, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(src + 4 * i));
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(vrev32q_u8(v)));
+    }
+    fromBigEndianScalar(src + 4 * i, dst + i, count - i);
+}
+
+#endif // QOSC_HAVE_NEON
+
+#endif // Q_BYTE_ORDER
+
+struct Kernels
+{
+    FindNulFunction findNul;
+    FromBigEndianFunction fromBigEndian;
+};
+
+Kernels detectKernels()
+{
+    Kernels kernels = { findNulScalar, fromBigEndianScalar };
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    kernels.fromBigEndian = fromBigEndianCopy;
+#elif defined(QOSC_HAVE_NEON)
+    kernels.findNul = findNulNeon;
+    kernels.fromBigEndian = fromBigEndianNeon;
+#elif defined(QOSC_HAVE_SSE2)
+    kernels.findNul = findNulSse2;
+    kernels.fromBigEndian = fromBigEndianSse2;
+#  if defined(QOSC_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.findNul = findNulAvx2;
+        kernels.fromBigEndian = fromBigEndianAvx2;
+    }
+#  endif
+#endif
+    return kernels;
+}
+
+const Kernels kernels = detectKernels();
+
+} // namespace
+
+int qt_oscFindNul(const char *data, quint32 from, quint32 size)
+{
+    return kernels.findNul(data, from, size);
+}
+
+void qt_oscWordsFromBigEndian(const char *src, quint32 *dst, int count)
+{
+    kernels.fromBigEndian(src, dst, count);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,36 @@
+#ifndef QOSCSIMD_P_H
+#define QOSCSIMD_P_H
+
+#include <QtCore/QtGlobal>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Vectorized kernels for the OSC parser.
+
+    Each kernel has a scalar fallback; the SSE2, AVX2 or NEON variant is
+    picked once at startup from the CPU the process runs on.
+*/
+
+// Returns the index of the first NULL byte in [from, size), or -1.
+int qt_oscFindNul(const char *data, quint32 from, quint32 size);
+
+// Converts \a count consecutive big-endian 32 bit words (OSC int32 and
+// float32 arguments) at \a src into host byte order at \a dst. \a src does
+// not need to be aligned.
+void qt_oscWordsFromBigEndian(const char *src, quint32 *dst, int count);
+
+inline float qt_oscWordToFloat(quint32 word)
+{
+    Q_STATIC_ASSERT(sizeof(float) == sizeof(quint32));
+    union {
+        quint32 u;
+        float f;
+    } value;
+    value.u = word;
+    return value.f;
+}
+
+QT_END_NAMESPACE
+
+#endif // QOSCSIMD_P_H
@@ -41,28 +41,58 @@
 #ifndef QTUIO_P_H
 #define QTUIO_P_H
 
+#include <QtCore/QByteArray>
+#include <QtCore/QtEndian>
+
+#include "qoscsimd_p.h"
+
 QT_BEGIN_NAMESPACE
 
-inline bool qt_readOscString(const QByteArray &source, QByteArray &dest, quint32 &pos)
+// Locates the OSC-string starting at \a pos in place. On success, \a length
+// is set to the length of the string (without its terminating NULL) and \a pos
+// is advanced past the padding.
+inline bool qt_scanOscString(const char *data, quint32 size, quint32 &pos, quint32 &length)
 {
-    int end = source.indexOf('\0', pos);
+    int end = qt_oscFindNul(data, pos, size);
     if (end < 0) {
-        pos = source.size();
-        dest = QByteArray();
+        pos = size;
+        length = 0;
         return false;
     }
 
-    dest = source.mid(pos, end - pos);
+    length = quint32(end) - pos;
 
     // Skip additional NULL bytes at the end of the string to make sure the
     // total number of bits a multiple of 32 bits ("OSC-string" in the
     // specification).
-    end += 4 - ((end - pos) % 4);
+    pos += length + 4 - (length % 4);
+    return true;
+}
+
+inline bool qt_readOscString(const QByteArray &source, QByteArray &dest, quint32 &pos)
+{
+    quint32 start = pos;
+    quint32 length = 0;
+    if (!qt_scanOscString(source.constData(), source.size(), pos, length)) {
+        dest = QByteArray();
+        return false;
+    }
 
-    pos = end;
+    dest = source.mid(start, length);
     return true;
 }
 
+// OSC int32 and float32 arguments are big-endian 32 bit words.
+inline qint32 qt_readOscInt(const char *data)
+{
+    return qint32(qFromBigEndian<quint32>(data));
+}
+
+inline float qt_readOscFloat(const char *data)
+{
+    return qt_oscWordToFloat(qFromBigEndian<quint32>(data));
+}
+
 QT_END_NAMESPACE
 
 #endif
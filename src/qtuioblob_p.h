@@ -10,6 +10,7 @@ class QTuioBlob
 
         QTuioBlob(int id = -1)
             : id_(id)
+            , slot_(-1)
             , x_()
             , y_()
             , angle_()
@@ -24,24 +25,16 @@ class QTuioBlob
         {}
 
         int id() const {return id_;}
+        void setId(int id) {id_ = id;}
 
-        void setX(float x ) {
-            if (state() == Qt::TouchPointStationary &&
-                    !qFuzzyCompare(x_ + 2.0, x + 2.0)) { // +2 because 1 is a valid value, and qFuzzyCompare can't cope with 0.0
-                setState(Qt::TouchPointMoved);
-            }
-            x_ = x;
-        }
-        float x() const {return x_;}
+        // a small index, unique among the live blobs and reused once released
+        int slot() const { return slot_; }
+        void setSlot(int slot) { slot_ = slot; }
 
-        void setY(float y) {
+        void setX(float x) { x_ = x; }
+        float x() const {return x_;}
 
-            if (state() == Qt::TouchPointStationary &&
-                    !qFuzzyCompare(y_ + 2.0, y + 2.0)) { // +2 because 1 is a valid value, and qFuzzyCompare can't cope with 0.0
-                setState(Qt::TouchPointMoved);
-            }
-            y_ = y;
-        }
+        void setY(float y) { y_ = y; }
         float y() const { return y_;}
 
 
@@ -58,10 +51,6 @@ class QTuioBlob
         {
             if (angle > M_PI)
                 angle = angle - M_PI * 2.0; // zero is pointing upwards, and is the default; but we want to have negative angles when rotating left
-            if (state() == Qt::TouchPointStationary &&
-                    !qFuzzyCompare(angle_ + 2.0, angle + 2.0)) { // +2 because 1 is a valid value, and qFuzzyCompare can't cope with 0.0
-                setState(Qt::TouchPointMoved);
-            }
             angle_ = angle;
         }
         float angle() const { return angle_; }
@@ -86,6 +75,7 @@ class QTuioBlob
 
     private:
         int id_;
+        int slot_;
         float x_;
         float y_;
         float angle_;
@@ -100,5 +90,6 @@ class QTuioBlob
         Qt::TouchPointState state_;
 
 };
+Q_DECLARE_TYPEINFO(QTuioBlob, Q_MOVABLE_TYPE); // not primitive either: id_ and slot_ start at -1
 
 #endif // TUIO_BLOB_H
@@ -0,0 +1,87 @@
+#ifndef QTUIOCLOCKSYNC_P_H
+#define QTUIOCLOCKSYNC_P_H
+
+#include <QtCore/QtGlobal>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Maps the clock of a tracker, as read from its bundle time tags, onto the
+    local clock datagrams are stamped with on arrival.
+
+    Every sample is the arrival time minus the tracker's time tag: the clock
+    offset plus however long that datagram spent in transit. The smallest
+    difference seen is the one closest to the offset itself, so that is the
+    estimate. The minimum is taken over a sliding window of BucketCount
+    buckets of BucketLength each, which lets the estimate follow the two
+    clocks drifting apart, and a tracker restarting with a different clock,
+    in bounded time and constant memory.
+
+    What the window can't tell is the fixed part of the network delay: a
+    mapped time is when the datagram would have arrived over the fastest
+    path seen recently.
+*/
+class QTuioClockSync
+{
+public:
+    enum { BucketCount = 8 };
+    static const qint64 BucketLength = Q_INT64_C(1000000000); // 1 s, in ns
+
+    QTuioClockSync()
+        : m_bucketStart(0)
+        , m_current(0)
+        , m_offset(0)
+        , m_valid(false)
+    {
+        for (int i = 0; i < BucketCount; ++i)
+            m_bucketMin[i] = std::numeric_limits<qint64>::max();
+    }
+
+    bool isValid() const { return m_valid; }
+    // local time minus tracker time, in ns
+    qint64 offset() const { return m_offset; }
+    qint64 toLocal(qint64 remoteTime) const { return remoteTime + m_offset; }
+
+    // \a remoteTime and \a localTime are in ns
+    void addSample(qint64 remoteTime, qint64 localTime)
+    {
+        if (!m_valid) {
+            m_bucketStart = localTime;
+            m_valid = true;
+        }
+
+        // start new buckets for the time since the last sample, forgetting
+        // the ones that fell out of the window
+        if (localTime - m_bucketStart >= BucketLength) {
+            const qint64 elapsed = (localTime - m_bucketStart) / BucketLength;
+            for (qint64 i = 0; i < qMin(elapsed, qint64(BucketCount)); ++i) {
+                m_current = (m_current + 1) % BucketCount;
+                m_bucketMin[m_current] = std::numeric_limits<qint64>::max();
+            }
+            m_bucketStart += elapsed * BucketLength;
+        }
+
+        const qint64 difference = localTime - remoteTime;
+        if (difference < m_bucketMin[m_current])
+            m_bucketMin[m_current] = difference;
+
+        m_offset = m_bucketMin[0];
+        for (int i = 1; i < BucketCount; ++i)
+            m_offset = qMin(m_offset, m_bucketMin[i]);
+    }
+
+private:
+    qint64 m_bucketMin[BucketCount];
+    qint64 m_bucketStart;
+    int m_current;
+    qint64 m_offset;
+    bool m_valid;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOCLOCKSYNC_P_H
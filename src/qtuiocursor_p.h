@@ -50,6 +50,7 @@ class QTuioCursor
 public:
     QTuioCursor(int id = -1)
         : m_id(id)
+        , m_slot(-1)
         , m_x(0)
         , m_y(0)
         , m_vx(0)
@@ -60,25 +61,16 @@ public:
     }
 
     int id() const { return m_id; }
+    void setId(int id) { m_id = id; }
 
-    void setX(float x)
-    {
-        if (state() == Qt::TouchPointStationary &&
-            !qFuzzyCompare(m_x + 2.0, x + 2.0)) { // +2 because 1 is a valid value, and qFuzzyCompare can't cope with 0.0
-            setState(Qt::TouchPointMoved);
-        }
-        m_x = x;
-    }
+    // a small index, unique among the live cursors and reused once released
+    int slot() const { return m_slot; }
+    void setSlot(int slot) { m_slot = slot; }
+
+    void setX(float x) { m_x = x; }
     float x() const { return m_x; }
 
-    void setY(float y)
-    {
-        if (state() == Qt::TouchPointStationary &&
-            !qFuzzyCompare(m_y + 2.0, y + 2.0)) { // +2 because 1 is a valid value, and qFuzzyCompare can't cope with 0.0
-            setState(Qt::TouchPointMoved);
-        }
-        m_y = y;
-    }
+    void setY(float y) { m_y = y; }
     float y() const { return m_y; }
 
     void setVX(float vx) { m_vx = vx; }
@@ -95,6 +87,7 @@ public:
 
 private:
     int m_id;
+    int m_slot;
     float m_x;
     float m_y;
     float m_vx;
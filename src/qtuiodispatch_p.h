@@ -0,0 +1,86 @@
+#ifndef QTUIODISPATCH_P_H
+#define QTUIODISPATCH_P_H
+
+#include <QtCore/QLatin1String>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Interned IDs for the TUIO 1.1 address patterns and commands the handler
+    understands. Both lookups cost a length check and one or two word
+    compares; nothing is copied.
+*/
+
+enum QTuioProfile {
+    QTuioUnknownProfile = -1,
+    QTuio2DCurProfile,
+    QTuio2DObjProfile,
+    QTuio2DBlbProfile,
+    QTuioProfileCount
+};
+
+enum QTuioCommand {
+    QTuioUnknownCommand = -1,
+    QTuioSourceCommand,
+    QTuioAliveCommand,
+    QTuioSetCommand,
+    QTuioFseqCommand,
+    QTuioCommandCount
+};
+
+Q_DECL_CONSTEXPR inline quint32 qt_tuioTag(char a, char b, char c, char d)
+{
+    return quint32(uchar(a)) | quint32(uchar(b)) << 8 | quint32(uchar(c)) << 16 | quint32(uchar(d)) << 24;
+}
+
+inline quint32 qt_tuioTag(const char *p)
+{
+    return qt_tuioTag(p[0], p[1], p[2], p[3]);
+}
+
+// Maps "/tuio/2Dcur", "/tuio/2Dobj" and "/tuio/2Dblb" to their profile.
+// The pattern must come from a valid OSC message, whose terminating NULL
+// is read as part of the last word.
+inline QTuioProfile qt_tuioProfile(QLatin1String address)
+{
+    if (address.size() != 11 || memcmp(address.data(), "/tuio/2D", 8) != 0)
+        return QTuioUnknownProfile;
+
+    switch (qt_tuioTag(address.data() + 8)) {
+    case qt_tuioTag('c', 'u', 'r', '\0'):
+        return QTuio2DCurProfile;
+    case qt_tuioTag('o', 'b', 'j', '\0'):
+        return QTuio2DObjProfile;
+    case qt_tuioTag('b', 'l', 'b', '\0'):
+        return QTuio2DBlbProfile;
+    default:
+        return QTuioUnknownProfile;
+    }
+}
+
+// Maps the leading string argument of a profile message to its command.
+// Like qt_tuioProfile(), relies on the OSC padding following the string.
+inline QTuioCommand qt_tuioCommand(QLatin1String command)
+{
+    const char *p = command.data();
+    switch (command.size()) {
+    case 3:
+        return qt_tuioTag(p) == qt_tuioTag('s', 'e', 't', '\0') ? QTuioSetCommand : QTuioUnknownCommand;
+    case 4:
+        return qt_tuioTag(p) == qt_tuioTag('f', 's', 'e', 'q') ? QTuioFseqCommand : QTuioUnknownCommand;
+    case 5:
+        return qt_tuioTag(p) == qt_tuioTag('a', 'l', 'i', 'v') && p[4] == 'e'
+                ? QTuioAliveCommand : QTuioUnknownCommand;
+    case 6:
+        return qt_tuioTag(p) == qt_tuioTag('s', 'o', 'u', 'r') && p[4] == 'c' && p[5] == 'e'
+                ? QTuioSourceCommand : QTuioUnknownCommand;
+    default:
+        return QTuioUnknownCommand;
+    }
+}
+
+QT_END_NAMESPACE
+
+#endif // QTUIODISPATCH_P_H
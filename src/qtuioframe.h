@@ -0,0 +1,129 @@
+#ifndef QTUIOFRAME_H
+#define QTUIOFRAME_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMetaType>
+#include <QtCore/QSharedData>
+#include <QtCore/QVector>
+
+#include "qtuiocursor_p.h"
+#include "qtuiotoken_p.h"
+#include "qtuioblob_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QTuioFrameData : public QSharedData
+{
+public:
+    QTuioFrameData()
+        : profile(-1)
+        , sourceId(-1)
+        , fseq(-1)
+        , timestamp(0)
+        , arrivalTime(0)
+        , synthesized(false)
+        , timeTag(1)
+        , trackerTime(0)
+        , localTrackerTime(0)
+        , predictedTime(0)
+    {
+    }
+
+    int profile; // the QTuioProfile whose FSEQ committed the frame
+    int sourceId;
+    QByteArray source;
+    qint32 fseq;
+    qint64 timestamp;
+    qint64 arrivalTime;
+    bool synthesized;
+    quint64 timeTag;
+    qint64 trackerTime;
+    qint64 localTrackerTime;
+    qint64 predictedTime;
+
+    QVector<QTuioCursor> cursors;
+    QVector<QTuioCursor> removedCursors;
+    QVector<QTuioToken> tokens;
+    QVector<QTuioToken> removedTokens;
+    QVector<QTuioBlob> blobs;
+    QVector<QTuioBlob> removedBlobs;
+};
+
+/*!
+    \internal
+
+    One committed TUIO frame of one source: the active sessions of every
+    profile, sorted by session ID, and the sessions released by the FSEQ that
+    committed it.
+
+    Frames are immutable and implicitly shared, so copying one only bumps an
+    atomic reference count. Any number of consumers, on any thread, can hold
+    on to the same frame, and queued connections pass it without copying the
+    sessions.
+*/
+class QTuioFrame
+{
+public:
+    QTuioFrame() : d(new QTuioFrameData) {}
+
+    // the tracker the frame came from, numbered from 0 in order of
+    // appearance, or -1 for frames merging all of them. The number of a
+    // source that timed out goes to the next new one.
+    int sourceId() const { return d->sourceId; }
+    // the name@address from the tracker's SOURCE messages, if it sends any
+    QByteArray source() const { return d->source; }
+
+    // the FSEQ frame ID. Stale and redundant (-1) frames are never committed.
+    qint32 fseq() const { return d->fseq; }
+    // when the frame was committed, in milliseconds since the epoch
+    qint64 timestamp() const { return d->timestamp; }
+    // when the datagram carrying the FSEQ arrived, in nanoseconds since the
+    // epoch. Taken by the kernel with the recvmmsg backend.
+    qint64 arrivalTime() const { return d->arrivalTime; }
+    // whether the handler committed the frame without waiting any longer
+    // for its FSEQ. fseq() is then still the one of the previous frame.
+    bool isSynthesized() const { return d->synthesized; }
+
+    // the OSC time tag of the bundle carrying the FSEQ, as sent: NTP format,
+    // 1 ("immediately") if the tracker doesn't stamp its bundles
+    quint64 timeTag() const { return d->timeTag; }
+    // the time tag in nanoseconds since the epoch, by the tracker's clock,
+    // or 0 if there is none
+    qint64 trackerTime() const { return d->trackerTime; }
+    // trackerTime() mapped onto the clock of arrivalTime(), estimated from
+    // the time tags of the tracker's recent bundles, or 0 if there is none.
+    // arrivalTime() - localTrackerTime() is the network jitter, and the
+    // current time minus localTrackerTime() the latency from the sensor to
+    // the application, not counting the fixed part of the network delay.
+    // With the two clocks synchronized (NTP, PTP), trackerTime() can be
+    // compared to local times directly.
+    qint64 localTrackerTime() const { return d->localTrackerTime; }
+    // for frames from QTuioHandler::predictedFrame() and interpolatedFrame(),
+    // the time the sessions were moved to, on the clock of arrivalTime();
+    // otherwise 0
+    qint64 predictedTime() const { return d->predictedTime; }
+
+    const QVector<QTuioCursor> &cursors() const { return d->cursors; }
+    const QVector<QTuioCursor> &removedCursors() const { return d->removedCursors; }
+    const QVector<QTuioToken> &tokens() const { return d->tokens; }
+    const QVector<QTuioToken> &removedTokens() const { return d->removedTokens; }
+    const QVector<QTuioBlob> &blobs() const { return d->blobs; }
+    const QVector<QTuioBlob> &removedBlobs() const { return d->removedBlobs; }
+
+private:
+    friend class QTuioFrameHistory;
+    friend class QTuioFramePool;
+    friend class QTuioHandler;
+    friend class QTuioInterpolator;
+    friend class QTuioJitterBuffer;
+    friend class QTuioPredictor;
+    explicit QTuioFrame(QTuioFrameData *data) : d(data) {}
+
+    QExplicitlySharedDataPointer<const QTuioFrameData> d;
+};
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QTuioFrame)
+
+#endif // QTUIOFRAME_H
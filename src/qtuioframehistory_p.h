@@ -0,0 +1,88 @@
+#ifndef QTUIOFRAMEHISTORY_P_H
+#define QTUIOFRAMEHISTORY_P_H
+
+#include <QtCore/QVector>
+
+#include "qtuiodispatch_p.h"
+#include "qtuioframe.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    The last two frames each profile of each source committed. Trackers
+    commit their profiles separately, a fraction of a millisecond apart, so
+    anything measuring the time between frames has to compare frames of the
+    same profile: the frame before the latest one of a source is usually the
+    same tracker frame, committed by another profile.
+
+    Source -1 is the merged source.
+*/
+class QTuioFrameHistory
+{
+public:
+    struct Entry
+    {
+        QTuioFrame previous;
+        QTuioFrame latest;
+    };
+
+    explicit QTuioFrameHistory(int maxSources)
+        : m_entries((maxSources + 1) * QTuioProfileCount)
+        , m_newestProfile(maxSources + 1, -1)
+        , m_lastSourceId(-1)
+    {
+    }
+
+    void addFrame(const QTuioFrame &frame)
+    {
+        const int source = frame.sourceId() + 1;
+        const int profile = frame.d->profile;
+        if (source < 0 || source >= m_newestProfile.size() || profile < 0 || profile >= QTuioProfileCount)
+            return;
+
+        Entry &entry = m_entries[source * QTuioProfileCount + profile];
+        entry.previous = entry.latest;
+        entry.latest = frame;
+        m_newestProfile[source] = profile;
+        m_lastSourceId = frame.sourceId();
+    }
+
+    // the source of the frame added last
+    int lastSourceId() const { return m_lastSourceId; }
+
+    // whether \a sourceId committed any frame yet
+    bool contains(int sourceId) const
+    {
+        return sourceId + 1 >= 0 && sourceId + 1 < m_newestProfile.size() && m_newestProfile.at(sourceId + 1) >= 0;
+    }
+
+    // when the tracker took \a frame, as well as can be told: the time the
+    // frames are spaced by
+    static qint64 referenceTime(const QTuioFrame &frame)
+    {
+        return frame.localTrackerTime() ? frame.localTrackerTime() : frame.arrivalTime();
+    }
+
+    const Entry &at(int sourceId, int profile) const
+    {
+        return m_entries.at((sourceId + 1) * QTuioProfileCount + profile);
+    }
+
+    // the frame \a sourceId committed last, of any profile; it holds the
+    // latest sessions of all of them
+    const QTuioFrame &newest(int sourceId) const
+    {
+        return at(sourceId, m_newestProfile.at(sourceId + 1)).latest;
+    }
+
+private:
+    QVector<Entry> m_entries;
+    QVector<int> m_newestProfile;
+    int m_lastSourceId;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOFRAMEHISTORY_P_H
@@ -0,0 +1,102 @@
+#ifndef QTUIOFRAMEPOOL_P_H
+#define QTUIOFRAMEPOOL_P_H
+
+#include <QtCore/QVector>
+
+#include <algorithm>
+
+#include "qtuioframe.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Frame buffers to build frames in, recycled once every frame made from
+    them has been let go of, so in steady state building frames allocates
+    nothing: a recycled buffer keeps the capacity of its session vectors.
+
+    A buffer only the pool refers to is free. The pool grows to \a maxSize
+    buffers while the consumers hold on to all of them; past that, the
+    oldest buffer is left to its holders for good.
+
+    Not thread safe, but frames built in the buffers may be released on any
+    thread.
+*/
+class QTuioFramePool
+{
+public:
+    explicit QTuioFramePool(int maxSize)
+        : m_maxSize(qMax(1, maxSize))
+        , m_next(0)
+    {
+    }
+
+    // a buffer to fill in, reset to what a new QTuioFrameData holds
+    QTuioFrameData *acquire()
+    {
+        for (int n = 0; n < m_buffers.size(); ++n) {
+            QTuioFrame &frame = m_buffers[m_next];
+            m_next = (m_next + 1) % m_buffers.size();
+            // acquire pairs with the release of whoever let go of it last
+            if (frame.d->ref.loadAcquire() == 1) {
+                QTuioFrameData *data = const_cast<QTuioFrameData *>(frame.d.data());
+                reset(data);
+                return data;
+            }
+        }
+
+        QTuioFrameData *data = new QTuioFrameData;
+        if (m_buffers.size() < m_maxSize) {
+            m_buffers.append(QTuioFrame(data));
+        } else {
+            m_buffers[m_next] = QTuioFrame(data);
+            m_next = (m_next + 1) % m_buffers.size();
+        }
+        return data;
+    }
+
+private:
+    static void reset(QTuioFrameData *data)
+    {
+        const QTuioFrameData initial;
+        data->profile = initial.profile;
+        data->sourceId = initial.sourceId;
+        data->source = QByteArray();
+        data->fseq = initial.fseq;
+        data->timestamp = initial.timestamp;
+        data->arrivalTime = initial.arrivalTime;
+        data->synthesized = initial.synthesized;
+        data->timeTag = initial.timeTag;
+        data->trackerTime = initial.trackerTime;
+        data->localTrackerTime = initial.localTrackerTime;
+        data->predictedTime = initial.predictedTime;
+        data->cursors.resize(0);
+        data->removedCursors.resize(0);
+        data->tokens.resize(0);
+        data->removedTokens.resize(0);
+        data->blobs.resize(0);
+        data->removedBlobs.resize(0);
+    }
+
+    QVector<QTuioFrame> m_buffers;
+    int m_maxSize;
+    int m_next;
+};
+
+/*!
+    \internal
+
+    Copies \a from into the storage \a to already has, rather than sharing
+    it: both stay writable without detaching.
+*/
+template <typename T>
+inline void qt_tuioCopySessions(const QVector<T> &from, QVector<T> &to)
+{
+    to.resize(from.size());
+    std::copy(from.constBegin(), from.constEnd(), to.begin());
+}
+
+QT_END_NAMESPACE
+
+#endif // QTUIOFRAMEPOOL_P_H
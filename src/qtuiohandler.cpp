@@ -1,47 +1,236 @@
 #include "qtuiohandler.h"
 
+#include <QDateTime>
 #include <QHostAddress>
+#include <QMutexLocker>
+#include <QTimer>
+#include <QtAlgorithms>
 
 #include "qtuiocursor_p.h"
 #include "qtuiotoken_p.h"
-#include "qoscbundle_p.h"
-#include "qoscmessage_p.h"
+#include "qtuio_p.h"
+#include "qoscbundleview_p.h"
+#include "qoscmessageview_p.h"
+#include "qoscsimd_p.h"
+#include "qtuiodispatch_p.h"
+#include "qtuiosetdecoder_p.h"
+#include "qudpbatchreceiver_p.h"
+
+// Reads the session IDs of an ALIVE message into \a ids, reusing its
+// storage. Returns false if any of them isn't an int, in which case the
+// whole message is ignored.
+static bool readAliveIds(const QOscMessageView &message, QVector<int> &ids)
+{
+    const int count = message.argumentCount() - 1;
+    for (int i = 1; i <= count; ++i) {
+        if (message.typeAt(i) != 'i') {
+            qWarning() << "Ignoring malformed TUIO alive message (bad argument on position" << i << message.typeTags() << ')';
+            return false;
+        }
+    }
 
-QTuioHandler::QTuioHandler(QObject *parent)
-    : QObject(parent)
-    , client_(0)
-    , active_cursors_()
-    , dead_cursors_()
-    , active_tokens_()
-    , dead_tokens_()
+    // all ints, so they are one run of words
+    ids.resize(count);
+    message.wordsAt(1, count, reinterpret_cast<quint32 *>(ids.data()));
+    return true;
+}
+
+// Returns the frame ID of an FSEQ message, or -1 (a redundant frame) if it
+// carries none.
+static qint32 readFseq(const QOscMessageView &message)
 {
-    client_ = new UdpClient(3333, QHostAddress::LocalHost);
+    return message.argumentCount() > 1 && message.typeAt(1) == 'i' ? message.intAt(1) : -1;
+}
 
-    connect(client_, &UdpClient::messageReceived,
-            this, &QTuioHandler::processPackets);
+QTuioHandler::QTuioHandler(QObject *parent)
+    : QTuioHandler(QHostAddress::LocalHost, 3333, Options(), parent)
+{
 }
 
 QTuioHandler::QTuioHandler(const QHostAddress &ip, unsigned port, QObject *parent)
+    : QTuioHandler(ip, port, Options(), parent)
+{
+}
+
+QTuioHandler::QTuioHandler(const QHostAddress &ip, unsigned port, const Options &options, QObject *parent)
     : QObject(parent)
     , client_(0)
-    , active_cursors_()
-    , dead_cursors_()
-    , active_tokens_()
-    , dead_tokens_()
+    , receiver_(0)
+    , ingest_thread_(0)
+    , delivery_pending_(0)
+    , jitter_timer_(0)
+    , coalesce_frames_(options.coalesceFrames)
+    , predictor_(qBound(1, options.maxSources, 128), qint64(options.maxPrediction) * 1000000)
+    , interpolator_(qBound(1, options.maxSources, 128))
+    , arrival_ns_(0)
+    , time_tag_(1)
+    , pattern_handlers_(0)
+    , merge_sources_(options.mergeSources)
+    , max_sources_(qBound(1, options.maxSources, 128))
+    , source_timeout_ns_(qint64(qMax(0, options.sourceTimeout)) * 1000000)
+    , expiry_timer_(0)
+    , source_(0)
+    , sender_(0)
+    , sender_port_(0)
+    , stale_profiles_(0)
+    , max_pending_alive_(qMax(1, options.maxPendingAliveCycles))
+    , max_dead_entries_(options.maxDeadEntries)
+    , max_staleness_ns_(qint64(options.maxStaleness) * 1000000)
+    , filter_parameters_(options.filter)
 {
-    client_ = new UdpClient(port, ip);
+    qRegisterMetaType<QTuioFrame>();
+
+    if (coalesce_frames_)
+        coalescing_.resize((max_sources_ + 1) * QTuioProfileCount);
+
+    // enough buffers for every frame the handler itself holds on to: queued,
+    // held back, coalesced, latestFrame()'s, and the latest ones of each
+    // source for predictedFrame() and interpolatedFrame(), plus a few for the
+    // consumer. Coalesced frames are built on the delivering thread, in a
+    // pool of their own.
+    if (options.recycleFrames) {
+        const int held = (options.threaded || coalesce_frames_ ? options.frameQueueSize : 0)
+                + (options.jitterBuffer ? options.jitterBufferSize : 0) + 3 * (max_sources_ + 1)
+                + coalescing_.size() + 3;
+        frame_pool_.reset(new QTuioFramePool(held + 8));
+        if (coalesce_frames_)
+            coalesce_pool_.reset(new QTuioFramePool(held + 8));
+    }
+
+    // frames are paced on this thread, whichever thread assembles them
+    if (options.jitterBuffer) {
+        jitter_buffer_.reset(new QTuioJitterBuffer(options.jitterBufferSize, max_sources_,
+                                                   qint64(options.maxJitterDelay) * 1000000));
+        jitter_timer_ = new QTimer(this);
+        jitter_timer_->setSingleShot(true);
+        jitter_timer_->setTimerType(Qt::PreciseTimer);
+        connect(jitter_timer_, &QTimer::timeout, this, &QTuioHandler::releaseBufferedFrames);
+    }
+
+    // coalesced frames wait in the ring too, for the event loop to get to
+    // them, even if they are assembled on this thread
+    if (options.threaded || coalesce_frames_)
+        frame_queue_.reset(new QTuioSpscRing<QTuioFrame>(options.frameQueueSize));
+
+    if (!options.threaded) {
+        startReceiving(ip, port, options);
+        return;
+    }
+
+    // the socket, and all the state it feeds, live on the ingest thread.
+    // Only finished frames cross over to this thread, through the ring.
+    ingest_thread_ = new QThread(this);
+    ingest_thread_->setObjectName(QStringLiteral("QTuioHandler ingest"));
 
-    connect(client_, &UdpClient::messageReceived,
-            this, &QTuioHandler::processPackets);
+    connect(ingest_thread_, &QThread::started, [this, ip, port, options]() {
+        startReceiving(ip, port, options);
+    });
+    connect(ingest_thread_, &QThread::finished, [this]() {
+        stopReceiving();
+    });
+
+    ingest_thread_->start();
 }
 
 QTuioHandler::~QTuioHandler()
-{}
+{
+    if (ingest_thread_) {
+        ingest_thread_->quit();
+        ingest_thread_->wait();
+    } else {
+        stopReceiving();
+    }
+    qDeleteAll(sources_);
+}
+
+void QTuioHandler::startReceiving(const QHostAddress &ip, unsigned port, const Options &options)
+{
+    // sources that went quiet are dropped even if nothing else arrives
+    if (source_timeout_ns_) {
+        expiry_timer_ = new QTimer;
+        expiry_timer_->start(qMax(100, options.sourceTimeout / 2));
+        connect(expiry_timer_, &QTimer::timeout, expiry_timer_, [this]() {
+            const qint64 arrival_ns = arrival_ns_;
+            arrival_ns_ = QDateTime::currentMSecsSinceEpoch() * 1000000;
+            expireSources(arrival_ns_);
+            arrival_ns_ = arrival_ns;
+        });
+    }
+
+    if (options.backend == Options::RecvmmsgBackend) {
+#ifdef Q_OS_LINUX
+        receiver_ = new QUdpBatchReceiver([this](const char *data, int size, const QHostAddress &sender,
+                                                 quint16 sender_port, qint64 arrival_ns) {
+            processDatagram(data, size, sender, sender_port, arrival_ns);
+        });
+        if (receiver_->bind(ip, quint16(port), options.receiveBufferSize, options.receiveBatchSize))
+            return;
+
+        delete receiver_;
+        receiver_ = 0;
+        qWarning("Could not set up the recvmmsg backend, falling back to UdpClient");
+#else
+        qWarning("The recvmmsg backend is only available on Linux, falling back to UdpClient");
+#endif
+    }
+
+    client_ = new UdpClient(port, ip);
+
+    // the client lives on the thread this runs on, so does the connection
+    connect(client_, &UdpClient::messageReceived, client_,
+            [this](const QByteArray &datagram, const QHostAddress &sender, unsigned sender_port) {
+        processPackets(datagram, sender, sender_port);
+    });
+}
+
+void QTuioHandler::stopReceiving()
+{
+#ifdef Q_OS_LINUX
+    delete receiver_;
+    receiver_ = 0;
+#endif
+    delete client_;
+    client_ = 0;
+    delete expiry_timer_;
+    expiry_timer_ = 0;
+}
+
+int QTuioHandler::addMessageHandler(const QByteArray &pattern, const MessageHandler &handler)
+{
+    QMutexLocker lock(&pattern_mutex_);
+    const int id = pattern_dispatcher_.addHandler(pattern, handler);
+    if (id >= 0)
+        pattern_handlers_.ref();
+    return id;
+}
+
+void QTuioHandler::removeMessageHandler(int id)
+{
+    QMutexLocker lock(&pattern_mutex_);
+    if (pattern_dispatcher_.removeHandler(id))
+        pattern_handlers_.deref();
+}
 
 void QTuioHandler::processPackets(const QByteArray& datagram, const QHostAddress& sender, unsigned sender_port)
 {
-    Q_UNUSED(sender);
-    Q_UNUSED(sender_port);
+    processDatagram(datagram.constData(), datagram.size(), sender, sender_port,
+                    QDateTime::currentMSecsSinceEpoch() * 1000000);
+}
+
+void QTuioHandler::processDatagram(const char *data, int size, const QHostAddress &sender,
+                                   unsigned sender_port, qint64 arrival_ns)
+{
+    arrival_ns_ = arrival_ns;
+    time_tag_ = QOscBundleView(data, quint32(size)).timeTag();
+
+    // until a SOURCE message says otherwise, the datagram is from the
+    // nameless source of its sender
+    sender_ = &sender;
+    sender_port_ = quint16(sender_port);
+    source_name_ = QLatin1String();
+    source_ = 0;
+    stale_profiles_ = findStaleProfiles(data, size);
+
     // "A typical TUIO bundle will contain an initial ALIVE message,
     // followed by an arbitrary number of SET messages that can fit into the
     // actual bundle capacity and a concluding FSEQ message. A minimal TUIO
@@ -49,447 +238,768 @@ void QTuioHandler::processPackets(const QByteArray& datagram, const QHostAddress
     // messages. The FSEQ frame ID is incremented for each delivered bundle,
     // while redundant bundles can be marked using the frame sequence ID
     // -1."
-    QVector<QOscMessage> messages;
-    QOscBundle bundle(datagram);
-    if (bundle.isValid()) {
-        messages = bundle.messages();
-    } else {
-        QOscMessage msg(datagram);
-        if (!msg.isValid()) {
-            qDebug().nospace() << Q_FUNC_INFO << " :" << __LINE__;
-            qDebug() << "  >" << "Got invalid datagram.";
-            return;
+    //
+    // messages are dispatched straight from the datagram, including those in
+    // nested bundles.
+    bool ok = QOscBundleView::forEachMessage(data, quint32(size), [this](const QOscMessageView &message) {
+        processMessage(message);
+    });
+
+    if (!ok) {
+        qDebug().nospace() << Q_FUNC_INFO << " :" << __LINE__;
+        qDebug() << "  >" << "Got invalid datagram.";
+    }
+
+    // the sender is gone with the datagram, and its source is no longer
+    // the current one: the expiry timer must be able to drop it
+    sender_ = 0;
+    source_name_ = QLatin1String();
+    source_ = 0;
+}
+
+int QTuioHandler::findStaleProfiles(const char *data, int size)
+{
+    // look for the FSEQ (and SOURCE) messages of the datagram up front,
+    // matching their fixed layout on the raw bytes, so nothing is parsed:
+    //   "/tuio/2Dcur\0" ",si\0" "fseq\0\0\0\0" <int32>
+    //   "/tuio/2Dcur\0" ",ss\0" "source\0\0" <name>
+    // Senders laying them out differently are caught on FSEQ instead.
+    qint32 fseq[QTuioProfileCount];
+    int fseq_profiles = 0;
+    QLatin1String name;
+    bool mixed_sources = false;
+
+    QOscBundleView::forEachMessageData(data, quint32(size), [&](const char *message, quint32 length) {
+        if (length < 28 || memcmp(message, "/tuio/2D", 8) != 0 || message[11] != '\0')
+            return true;
+        const QTuioProfile profile = qt_tuioProfile(QLatin1String(message, 11));
+        if (profile == QTuioUnknownProfile)
+            return true;
+
+        if (length == 28 && memcmp(message + 12, ",si\0fseq\0\0\0\0", 12) == 0) {
+            fseq[profile] = qt_readOscInt(message + 24);
+            fseq_profiles |= 1 << profile;
+        } else if (memcmp(message + 12, ",ss\0source\0\0", 12) == 0) {
+            const QLatin1String source(message + 24, int(qstrnlen(message + 24, length - 24)));
+            mixed_sources |= name.data() && name != source;
+            name = source;
+        }
+        return true;
+    });
+
+    // one datagram multiplexing several sources is left to the FSEQ checks
+    if (!fseq_profiles || mixed_sources)
+        return 0;
+
+    // a source seen for the first time has nothing to be stale against. The
+    // datagram's messages still select it the usual way.
+    QTuioSource *source = 0;
+    for (QTuioSource *known : sources_) {
+        if (known->matches(*sender_, sender_port_, name)) {
+            source = known;
+            break;
         }
-        messages.push_back(msg);
-    }
-
-    for (const QOscMessage &message : messages) {
-        if (message.addressPattern() == "/tuio/2Dcur") {
-
-            QList<QVariant> arguments = message.arguments();
-            if (arguments.count() == 0) {
-                qWarning("Ignoring TUIO message with no arguments");
-                return;
-            }
-
-            QByteArray message_type = arguments.at(0).toByteArray();
-            if (message_type == "source") {
-                process2DCurSource(message);
-            } else if (message_type == "alive") {
-                process2DCurAlive(message);
-            } else if (message_type == "set") {
-                process2DCurSet(message);
-            } else if (message_type == "fseq") {
-                process2DCurFseq(message);
-            } else {
-                qWarning() << "Ignoring unknown TUIO message type: " << message_type;
-                return;
-            }
-        } else if (message.addressPattern() == "/tuio/2Dobj") {
-            QList<QVariant> arguments = message.arguments();
-            if (arguments.count() == 0) {
-                qWarning("Ignoring TUIO message with no arguments");
-                return;
-            }
-
-            QByteArray message_type = arguments.at(0).toByteArray();
-            if (message_type == "source") {
-                process2DObjSource(message);
-            } else if (message_type == "alive") {
-                process2DObjAlive(message);
-            } else if (message_type == "set") {
-                process2DObjSet(message);
-            } else if (message_type == "fseq") {
-                process2DObjFseq(message);
-            } else {
-                qWarning() << "Ignoring unknown TUIO message type: " << message_type;
-                return;
-            }
-        } else if (message.addressPattern() == "/tuio/2Dblb") {
-
-            QList<QVariant> arguments = message.arguments();
-            if (arguments.count() == 0) {
-                qWarning("Ignoring TUIO message with no arguments");
-                return;
-            }
-
-            QByteArray message_type = arguments.at(0).toByteArray();
-            if (message_type == "source") {
-                process2DBlbSource(message);
-            } else if (message_type == "alive") {
-                process2DBlbAlive(message);
-            } else if (message_type == "set") {
-                process2DBlbSet(message);
-            } else if (message_type == "fseq") {
-                process2DBlbFseq(message);
-            } else {
-                qWarning() << "Ignoring unknown TUIO message type: " << message_type;
-                return;
-            }
+    }
+    if (!source)
+        return 0;
+
+    // redundant and stale frames are never decoded, so findSource() may not
+    // get to see them, but they still show the source is alive: a tracker
+    // with nothing moving sends nothing else
+    source->lastHeard = arrival_ns_;
+
+    int stale = 0;
+    for (int profile = 0; profile < QTuioProfileCount; ++profile) {
+        if (!(fseq_profiles & (1 << profile)))
+            continue;
+        const qint32 last = source->fseq[profile];
+        if (fseq[profile] == -1 || (last != -1 && !qt_tuioFseqIsNewer(fseq[profile], last)))
+            stale |= 1 << profile;
+    }
+    return stale;
+}
 
+void QTuioHandler::processMessage(const QOscMessageView &message)
+{
+    typedef void (QTuioHandler::*MessageHandler)(const QOscMessageView &);
+    static const MessageHandler handlers[QTuioProfileCount][QTuioCommandCount] = {
+        { &QTuioHandler::process2DCurSource, &QTuioHandler::process2DCurAlive,
+          &QTuioHandler::process2DCurSet, &QTuioHandler::process2DCurFseq },
+        { &QTuioHandler::process2DObjSource, &QTuioHandler::process2DObjAlive,
+          &QTuioHandler::process2DObjSet, &QTuioHandler::process2DObjFseq },
+        { &QTuioHandler::process2DBlbSource, &QTuioHandler::process2DBlbAlive,
+          &QTuioHandler::process2DBlbSet, &QTuioHandler::process2DBlbFseq }
+    };
+
+    // registered handlers see every message, including the built-in profiles.
+    // They are called without the lock held, so they may add or remove
+    // handlers themselves.
+    bool dispatched = false;
+    if (pattern_handlers_.load()) {
+        QOscPatternDispatcher::Match match;
+        {
+            QMutexLocker lock(&pattern_mutex_);
+            match = pattern_dispatcher_.match(message.addressPattern());
+        }
+        match.dispatch(message);
+        dispatched = !match.isEmpty();
+    }
 
-        } else {
+    // an unknown or malformed message only drops itself, never the rest of
+    // the bundle it came in
+    const QTuioProfile profile = qt_tuioProfile(message.addressPattern());
+    if (profile == QTuioUnknownProfile) {
+        if (!dispatched)
             qWarning() << "Ignoring unknown address pattern " << message.addressPattern();
+        return;
+    }
+
+    if (message.argumentCount() == 0 || message.typeAt(0) != 's') {
+        qWarning("Ignoring TUIO message with no arguments");
+        return;
+    }
+
+    const QLatin1String message_type = message.stringAt(0);
+    const QTuioCommand command = qt_tuioCommand(message_type);
+    if (command == QTuioUnknownCommand) {
+        qWarning() << "Ignoring unknown TUIO message type: " << message_type;
+        return;
+    }
+
+    if (command != QTuioSourceCommand) {
+        // the whole frame is known to be stale, don't bother decoding it
+        if (stale_profiles_ & (1 << profile))
+            return;
+        if (!source_ && !(source_ = findSource()))
             return;
+    }
+
+    (this->*handlers[profile][command])(message);
+}
+
+QTuioSource *QTuioHandler::findSource()
+{
+    for (QTuioSource *source : sources_) {
+        if (source->matches(*sender_, sender_port_, source_name_)) {
+            source->lastHeard = arrival_ns_;
+            return source;
         }
     }
+
+    // make room by dropping the sources that went quiet, if there are any
+    if (sources_.size() >= max_sources_)
+        expireSources(arrival_ns_);
+    if (sources_.size() >= max_sources_) {
+        qWarning() << "Ignoring TUIO source" << source_name_ << "from" << sender_->toString()
+                   << ", already tracking" << sources_.size() << "sources";
+        return 0;
+    }
+
+    QTuioSource *source = new QTuioSource(source_ids_.allocate(), *sender_, sender_port_, source_name_);
+    source->lastHeard = arrival_ns_;
+    source->cursorFilter.setParameters(filter_parameters_);
+    source->tokenFilter.setParameters(filter_parameters_);
+    source->blobFilter.setParameters(filter_parameters_);
+
+    // merged frames list the sources' sessions in the order of their IDs
+    int i = 0;
+    while (i < sources_.size() && sources_.at(i)->id < source->id)
+        ++i;
+    sources_.insert(i, source);
+    return source;
 }
 
-void QTuioHandler::process2DCurSource(const QOscMessage &message)
+// Drops the sources not heard from for the source timeout, other than the
+// one whose messages are being processed.
+void QTuioHandler::expireSources(qint64 now)
 {
-    QList<QVariant> arguments = message.arguments();
-    if (arguments.count() != 2) {
-        qWarning() << "Ignoring malformed TUIO source message: " << arguments.count();
+    if (!source_timeout_ns_)
         return;
+
+    QTuioSource *const current = source_;
+    const quint64 time_tag = time_tag_;
+    for (int i = 0; i < sources_.size();) {
+        QTuioSource *source = sources_.at(i);
+        if (source == current || now - source->lastHeard <= source_timeout_ns_) {
+            ++i;
+            continue;
+        }
+
+        qWarning() << "TUIO source" << source->name << "timed out";
+        releaseSource(source);
+        sources_.remove(i);
+        source_ids_.release(source->id);
+        delete source;
     }
+    source_ = current;
+    time_tag_ = time_tag;
+}
 
-    if (QMetaType::Type(arguments.at(1).type()) != QMetaType::QByteArray) {
-        qWarning("Ignoring malformed TUIO source message (bad argument type)");
-        return;
+// Releases every session of \a source, in a synthesized frame per profile
+// that has any, and gives their slots back.
+void QTuioHandler::releaseSource(QTuioSource *source)
+{
+    source_ = source;
+    time_tag_ = 1;
+    alive_ids_.resize(0);
+
+    if (source->cursors.isEmpty()) {
+        discardStagedFrame(QTuio2DCurProfile);
+    } else {
+        source->cursors.setAlive(alive_ids_.data(), 0);
+        commitStagedFrame(QTuio2DCurProfile, true);
+    }
+
+    if (source->tokens.isEmpty()) {
+        discardStagedFrame(QTuio2DObjProfile);
+    } else {
+        source->tokens.setAlive(alive_ids_.data(), 0);
+        commitStagedFrame(QTuio2DObjProfile, true);
+    }
+
+    if (source->blobs.isEmpty()) {
+        discardStagedFrame(QTuio2DBlbProfile);
+    } else {
+        source->blobs.setAlive(alive_ids_.data(), 0);
+        commitStagedFrame(QTuio2DBlbProfile, true);
     }
 }
 
-void QTuioHandler::process2DCurAlive(const QOscMessage &message)
+// Moves the sessions a frame released from \a dead into the frame's
+// \a removed, with their IDs made unique across sources if \a source_id is
+// not -1. Both keep their storage.
+template <typename T>
+static void takeRemovedSessions(QVector<T> &dead, QVector<T> &removed, int source_id)
 {
-    QList<QVariant> arguments = message.arguments();
+    qt_tuioCopySessions(dead, removed);
+    if (source_id >= 0) {
+        for (T &session : removed)
+            session.setId(qt_tuioGlobalId(source_id, session.id()));
+    }
+    dead.resize(0);
+}
 
-    // delta the notified cursors that are active, against the ones we already
-    // know of.
-    //
-    // TBD: right now we're assuming one 2Dcur alive message corresponds to a
-    // new data source from the input. is this correct, or do we need to store
-    // changes and only process the deltas on fseq?
-    QMap<int, QTuioCursor> old_active_cursors = active_cursors_;
-    QMap<int, QTuioCursor> new_active_cursors;
-
-    for (int i = 1; i < arguments.count(); ++i) {
-        if (QMetaType::Type(arguments.at(i).type()) != QMetaType::Int) {
-            qWarning() << "Ignoring malformed TUIO alive message (bad argument on position" << i << arguments << ')';
-            return;
+// Collects the sessions of every source into \a merged, with globally unique
+// IDs. Only the sessions of \a committing keep their state; the others were
+// already reported as pressed or moved in their own source's frames.
+template <typename T>
+static void mergeSessions(const QVector<QTuioSource *> &sources, QTuioSessionFilter<T> QTuioSource::*filter,
+                          const QTuioSource *committing, QVector<T> &merged)
+{
+    merged.resize(0);
+    for (const QTuioSource *source : sources) {
+        for (T session : (source->*filter).output()) {
+            session.setId(qt_tuioGlobalId(source->id, session.id()));
+            if (source != committing)
+                session.setState(Qt::TouchPointStationary);
+            merged.append(session);
         }
+    }
+}
 
-        int cursor_id = arguments.at(i).toInt();
-        if (!old_active_cursors.contains(cursor_id)) {
-            // newly active
-            QTuioCursor cursor(cursor_id);
-            cursor.setState(Qt::TouchPointPressed);
-            new_active_cursors.insert(cursor_id, cursor);
-        } else {
-            // we already know about it, remove it so it isn't marked as released
-            QTuioCursor cursor = old_active_cursors.value(cursor_id);
-            cursor.setState(Qt::TouchPointStationary); // position change in SET will update if needed
-            new_active_cursors.insert(cursor_id, cursor);
-            old_active_cursors.remove(cursor_id);
-        }
+bool QTuioHandler::acceptFrame(int profile, qint32 fseq)
+{
+    // redundant frames repeat what the previous ones said, and a frame
+    // reordered behind a newer one would move everything back in time
+    qint32 &last = source_->fseq[profile];
+    if (fseq == -1 || (last != -1 && !qt_tuioFseqIsNewer(fseq, last)))
+        return false;
+
+    last = fseq;
+    return true;
+}
+
+// Bounds what a sender that never ends its frames can pile up. Called on
+// every ALIVE, before it replaces the staged frame, \a released being the
+// sessions that frame drops. Once a limit is hit, the staged frame is
+// committed as it is, with the SETs that followed its ALIVE, and the new
+// ALIVE starts the next one.
+void QTuioHandler::checkStagedFrame(int profile, int released)
+{
+    int &cycles = source_->pendingAlive[profile];
+    if (cycles > 0 && (cycles >= max_pending_alive_ || released > max_dead_entries_
+                       || arrival_ns_ - source_->stagedSince[profile] > max_staleness_ns_)) {
+        forced_flushes_.ref();
+        commitStagedFrame(profile, true);
     }
 
-    // anything left is dead now
-    QMap<int, QTuioCursor>::ConstIterator it = old_active_cursors.constBegin();
+    if (cycles++ == 0)
+        source_->stagedSince[profile] = arrival_ns_;
+}
 
-    // deadCursors should be cleared from the last FSEQ now
-    dead_cursors_.reserve(old_active_cursors.size());
+void QTuioHandler::commitStagedFrame(int profile, bool synthesized)
+{
+    source_->pendingAlive[profile] = 0;
+
+    // the filters go by the tracker's clock when it has one, it doesn't
+    // suffer from the network's jitter
+    qint64 measured = arrival_ns_;
+    if (time_tag_ > 1) {
+        measured = QOscBundleView::toNsecsSinceEpoch(time_tag_);
+        source_->clock.addSample(measured, arrival_ns_);
+    }
 
-    // TODO: there could be an issue of resource exhaustion here if FSEQ isn't
-    // sent in a timely fashion. we should probably track message counts and
-    // force-flush if we get too many built up.
-    while (it != old_active_cursors.constEnd()) {
-        dead_cursors_.append(it.value());
-        ++it;
+    QTuioFrameData *data = 0;
+    switch (profile) {
+    case QTuio2DCurProfile:
+        source_->cursors.commit(source_->deadCursors, cursor_slots_);
+        source_->cursorFilter.apply(source_->cursors.values(), measured);
+        data = newFrameData(profile);
+        takeRemovedSessions(source_->deadCursors, data->removedCursors, merge_sources_ ? source_->id : -1);
+        break;
+    case QTuio2DObjProfile:
+        source_->tokens.commit(source_->deadTokens, token_slots_);
+        source_->tokenFilter.apply(source_->tokens.values(), measured);
+        data = newFrameData(profile);
+        takeRemovedSessions(source_->deadTokens, data->removedTokens, merge_sources_ ? source_->id : -1);
+        break;
+    case QTuio2DBlbProfile:
+        source_->blobs.commit(source_->deadBlobs, blob_slots_);
+        source_->blobFilter.apply(source_->blobs.values(), measured);
+        data = newFrameData(profile);
+        takeRemovedSessions(source_->deadBlobs, data->removedBlobs, merge_sources_ ? source_->id : -1);
+        break;
     }
 
-    active_cursors_ = new_active_cursors;
+    data->synthesized = synthesized;
+    commitFrame(QTuioFrame(data));
 }
 
-void QTuioHandler::process2DCurSet(const QOscMessage &message)
+void QTuioHandler::discardStagedFrame(int profile)
 {
-    QList<QVariant> arguments = message.arguments();
-    if (arguments.count() < 7) {
-        qWarning() << "Ignoring malformed TUIO set message with too few arguments: " << arguments.count();
-        return;
+    source_->pendingAlive[profile] = 0;
+
+    switch (profile) {
+    case QTuio2DCurProfile:
+        source_->cursors.discard();
+        break;
+    case QTuio2DObjProfile:
+        source_->tokens.discard();
+        break;
+    case QTuio2DBlbProfile:
+        source_->blobs.discard();
+        break;
     }
+}
 
-    if (QMetaType::Type(arguments.at(1).type()) != QMetaType::Int   ||
-            QMetaType::Type(arguments.at(2).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(3).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(4).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(5).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(6).type()) != QMetaType::Float
-            ) {
-        qWarning() << "Ignoring malformed TUIO set message with bad types: " << arguments;
+QTuioFrameData *QTuioHandler::newFrameData(int profile)
+{
+    QTuioFrameData *data = frame_pool_ ? frame_pool_->acquire() : new QTuioFrameData;
+    data->profile = profile;
+    data->fseq = source_->fseq[profile];
+    data->timestamp = QDateTime::currentMSecsSinceEpoch();
+    data->arrivalTime = arrival_ns_;
+
+    // 0 is an invalid bundle, or a bare message
+    if (time_tag_ > 1) {
+        data->timeTag = time_tag_;
+        data->trackerTime = QOscBundleView::toNsecsSinceEpoch(time_tag_);
+        data->localTrackerTime = source_->clock.toLocal(data->trackerTime);
+    }
+
+    if (merge_sources_) {
+        data->sourceId = -1;
+        mergeSessions(sources_, &QTuioSource::cursorFilter, source_, data->cursors);
+        mergeSessions(sources_, &QTuioSource::tokenFilter, source_, data->tokens);
+        mergeSessions(sources_, &QTuioSource::blobFilter, source_, data->blobs);
+        return data;
+    }
+
+    data->sourceId = source_->id;
+    data->source = source_->name;
+    if (frame_pool_) {
+        // copied into the storage the recycled buffer already has
+        qt_tuioCopySessions(source_->cursorFilter.output(), data->cursors);
+        qt_tuioCopySessions(source_->tokenFilter.output(), data->tokens);
+        qt_tuioCopySessions(source_->blobFilter.output(), data->blobs);
+    } else {
+        // the filtered sessions are implicitly shared into the frame
+        data->cursors = source_->cursorFilter.output();
+        data->tokens = source_->tokenFilter.output();
+        data->blobs = source_->blobFilter.output();
+    }
+    return data;
+}
+
+void QTuioHandler::commitFrame(const QTuioFrame &frame)
+{
+    latest_frame_.write(frame);
+
+    if (!frame_queue_) {
+        scheduleFrame(frame);
         return;
     }
 
-    int cursor_id = arguments.at(1).toInt();
-    float x = arguments.at(2).toFloat();
-    float y = arguments.at(3).toFloat();
-    float vx = arguments.at(4).toFloat();
-    float vy = arguments.at(5).toFloat();
-    float acceleration = arguments.at(6).toFloat();
+    if (!frame_queue_->push(frame))
+        qWarning() << "Dropping TUIO frame" << frame.fseq() << ", the consumer is not keeping up";
 
-    QMap<int, QTuioCursor>::Iterator it = active_cursors_.find(cursor_id);
-    if (it == active_cursors_.end()) {
-        qWarning() << "Ignoring malformed TUIO set for nonexistent cursor " << cursor_id;
+    // one queued call drains however many frames piled up meanwhile
+    if (!delivery_pending_.fetchAndStoreOrdered(1))
+        QMetaObject::invokeMethod(this, "deliverQueuedFrames", Qt::QueuedConnection);
+}
+
+void QTuioHandler::deliverQueuedFrames()
+{
+    delivery_pending_.storeRelease(0);
+    if (!coalesce_frames_) {
+        while (frame_queue_->pop(queued_frame_))
+            scheduleFrame(queued_frame_);
         return;
     }
 
-//    qDebug().nospace() << Q_FUNC_INFO << " :" << __LINE__;
-//    qDebug() << "  >" << "Processing SET for " << cursorId << " x: " << x << y << vx << vy << acceleration;
+    while (frame_queue_->pop(queued_frame_)) {
+        Coalescing &coalescing = coalescing_[(queued_frame_.sourceId() + 1) * QTuioProfileCount
+                                             + queued_frame_.d->profile];
+        coalescing.latest = queued_frame_;
+        ++coalescing.count;
+    }
 
-    QTuioCursor &cur = *it;
-    cur.setX(x);
-    cur.setY(y);
-    cur.setVX(vx);
-    cur.setVY(vy);
-    cur.setAcceleration(acceleration);
+    for (Coalescing &coalescing : coalescing_) {
+        if (!coalescing.count)
+            continue;
+
+        // a single frame already is relative to the one emitted before it
+        if (coalescing.count == 1)
+            coalescing.emitted = coalescing.latest;
+        else
+            coalescing.emitted = coalescedFrame(coalescing.emitted, coalescing.latest);
+        coalescing.latest = QTuioFrame();
+        coalescing.count = 0;
+        scheduleFrame(coalescing.emitted);
+    }
 }
 
+// Sets \a active to the sessions of \a latest, pressed, moved or stationary
+// relative to \a previous, and \a removed to the sessions of \a previous no
+// longer in it. Both lists are sorted by ID, so this is one merge.
+template <typename T>
+static void coalesceSessions(const QVector<T> &previous, const QVector<T> &latest, QVector<T> &active,
+                             QVector<T> &removed)
+{
+    active.resize(0);
+    removed.resize(0);
+    int i = 0;
+    for (const T &session : latest) {
+        while (i < previous.size() && previous.at(i).id() < session.id())
+            removed.append(previous.at(i++));
+
+        active.append(session);
+        if (i < previous.size() && previous.at(i).id() == session.id()) {
+            const bool moved = qt_tuioSessionMoved(previous.at(i++), session);
+            active.last().setState(moved ? Qt::TouchPointMoved : Qt::TouchPointStationary);
+        } else {
+            active.last().setState(Qt::TouchPointPressed);
+        }
+    }
+    while (i < previous.size())
+        removed.append(previous.at(i++));
+}
 
-void QTuioHandler::process2DCurFseq(const QOscMessage &message)
+// \a latest, with the changes of the frames skipped since \a previous folded
+// into its profile's sessions. Sessions that came and went in between are
+// never reported.
+QTuioFrame QTuioHandler::coalescedFrame(const QTuioFrame &previous, const QTuioFrame &latest)
 {
-    Q_UNUSED(message);
-    emit cursorEvent(active_cursors_, dead_cursors_);
-    dead_cursors_.clear();
+    const QTuioFrameData &from = *latest.d;
+    QTuioFrameData *data = coalesce_pool_ ? coalesce_pool_->acquire() : new QTuioFrameData;
+    data->profile = from.profile;
+    data->sourceId = from.sourceId;
+    data->source = from.source;
+    data->fseq = from.fseq;
+    data->timestamp = from.timestamp;
+    data->arrivalTime = from.arrivalTime;
+    data->synthesized = from.synthesized;
+    data->timeTag = from.timeTag;
+    data->trackerTime = from.trackerTime;
+    data->localTrackerTime = from.localTrackerTime;
+    qt_tuioCopySessions(from.cursors, data->cursors);
+    qt_tuioCopySessions(from.tokens, data->tokens);
+    qt_tuioCopySessions(from.blobs, data->blobs);
+
+    switch (from.profile) {
+    case QTuio2DCurProfile:
+        coalesceSessions(previous.cursors(), from.cursors, data->cursors, data->removedCursors);
+        break;
+    case QTuio2DObjProfile:
+        coalesceSessions(previous.tokens(), from.tokens, data->tokens, data->removedTokens);
+        break;
+    case QTuio2DBlbProfile:
+        coalesceSessions(previous.blobs(), from.blobs, data->blobs, data->removedBlobs);
+        break;
+    }
+
+    return QTuioFrame(data);
 }
 
-void QTuioHandler::process2DObjSource(const QOscMessage &message)
+void QTuioHandler::scheduleFrame(const QTuioFrame &frame)
 {
-    QList<QVariant> arguments = message.arguments();
-    if (arguments.count() != 2) {
-        qWarning() << "Ignoring malformed TUIO source message: " << arguments.count();
+    if (!jitter_buffer_) {
+        deliverFrame(frame);
         return;
     }
 
-    if (QMetaType::Type(arguments.at(1).type()) != QMetaType::QByteArray) {
-        qWarning("Ignoring malformed TUIO source message (bad argument type)");
-        return;
+    // with the buffer full, the oldest frame goes out early rather than the
+    // latency growing
+    if (jitter_buffer_->isFull()) {
+        jitter_buffer_->pop(buffered_frame_);
+        deliverFrame(buffered_frame_);
     }
+
+    jitter_buffer_->push(frame);
+    releaseBufferedFrames();
 }
 
-void QTuioHandler::process2DObjAlive(const QOscMessage &message)
+void QTuioHandler::releaseBufferedFrames()
 {
-    QList<QVariant> arguments = message.arguments();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch() * 1000000;
+    while (!jitter_buffer_->isEmpty() && jitter_buffer_->nextReleaseTime() <= now) {
+        jitter_buffer_->pop(buffered_frame_);
+        deliverFrame(buffered_frame_);
+    }
 
-    // delta the notified tokens that are active, against the ones we already
-    // know of.
-    //
-    // TBD: right now we're assuming one 2DObj alive message corresponds to a
-    // new data source from the input. is this correct, or do we need to store
-    // changes and only process the deltas on fseq?
-    QMap<int, QTuioToken> old_active_tokens = active_tokens_;
-    QMap<int, QTuioToken> new_active_tokens;
-
-    for (int i = 1; i < arguments.count(); ++i) {
-        if (QMetaType::Type(arguments.at(i).type()) != QMetaType::Int) {
-            qWarning() << "Ignoring malformed TUIO alive message (bad argument on position" << i << arguments << ')';
-            return;
-        }
+    if (!jitter_buffer_->isEmpty())
+        jitter_timer_->start(int((jitter_buffer_->nextReleaseTime() - now + 999999) / 1000000));
+}
 
-        int session_id = arguments.at(i).toInt();
-        if (!old_active_tokens.contains(session_id)) {
-            // newly active
-            QTuioToken token(session_id);
-            token.setState(Qt::TouchPointPressed);
-            new_active_tokens.insert(session_id, token);
-        } else {
-            // we already know about it, remove it so it isn't marked as released
-            QTuioToken token = old_active_tokens.value(session_id);
-            token.setState(Qt::TouchPointStationary); // position change in SET will update if needed
-            new_active_tokens.insert(session_id, token);
-            old_active_tokens.remove(session_id);
-        }
+// Splits \a sessions into the ones added and the ones moved since the
+// previous frame, reusing the storage of both.
+template <typename T>
+static void collectChanges(const QVector<T> &sessions, QVector<T> &added, QVector<T> &updated)
+{
+    added.resize(0);
+    updated.resize(0);
+    for (const T &session : sessions) {
+        if (session.state() == Qt::TouchPointPressed)
+            added.append(session);
+        else if (session.state() == Qt::TouchPointMoved)
+            updated.append(session);
     }
+}
 
-    // anything left is dead now
-    QMap<int, QTuioToken>::ConstIterator it = old_active_tokens.constBegin();
+QTuioFrame QTuioHandler::predictedFrame(qint64 targetTime) const
+{
+    return predictor_.predictedFrame(targetTime, predictor_.lastSourceId());
+}
 
-    // deadTokens should be cleared from the last FSEQ now
-    dead_tokens_.reserve(old_active_tokens.size());
+QTuioFrame QTuioHandler::predictedFrame(qint64 targetTime, int sourceId) const
+{
+    return predictor_.predictedFrame(targetTime, sourceId);
+}
 
-    // TODO: there could be an issue of resource exhaustion here if FSEQ isn't
-    // sent in a timely fashion. we should probably track message counts and
-    // force-flush if we get too many built up.
-    while (it != old_active_tokens.constEnd()) {
-        dead_tokens_.append(it.value());
-        ++it;
-    }
+QTuioFrame QTuioHandler::interpolatedFrame(qint64 time)
+{
+    return interpolator_.interpolatedFrame(time, interpolator_.lastSourceId());
+}
 
-    active_tokens_ = new_active_tokens;
+QTuioFrame QTuioHandler::interpolatedFrame(qint64 time, int sourceId)
+{
+    return interpolator_.interpolatedFrame(time, sourceId);
 }
 
-void QTuioHandler::process2DObjSet(const QOscMessage &message)
+void QTuioHandler::deliverFrame(const QTuioFrame &frame)
 {
-    QList<QVariant> arguments = message.arguments();
-    if (arguments.count() < 7) {
-        qWarning() << "Ignoring malformed TUIO set message with too few arguments: " << arguments.count();
-        return;
+    predictor_.addFrame(frame);
+    interpolator_.addFrame(frame);
+    emit frameReady(frame);
+
+    switch (frame.d->profile) {
+    case QTuio2DCurProfile:
+        emit cursorEvent(frame.cursors(), frame.removedCursors());
+
+        collectChanges(frame.cursors(), added_cursors_, updated_cursors_);
+        if (!added_cursors_.isEmpty())
+            emit cursorsAdded(added_cursors_);
+        if (!updated_cursors_.isEmpty())
+            emit cursorsUpdated(updated_cursors_);
+        if (!frame.removedCursors().isEmpty())
+            emit cursorsRemoved(frame.removedCursors());
+        break;
+    case QTuio2DObjProfile:
+        emit tokenEvent(frame.tokens(), frame.removedTokens());
+
+        collectChanges(frame.tokens(), added_tokens_, updated_tokens_);
+        if (!added_tokens_.isEmpty())
+            emit tokensAdded(added_tokens_);
+        if (!updated_tokens_.isEmpty())
+            emit tokensUpdated(updated_tokens_);
+        if (!frame.removedTokens().isEmpty())
+            emit tokensRemoved(frame.removedTokens());
+        break;
+    case QTuio2DBlbProfile:
+        emit blobEvent(frame.blobs(), frame.removedBlobs());
+
+        collectChanges(frame.blobs(), added_blobs_, updated_blobs_);
+        if (!added_blobs_.isEmpty())
+            emit blobsAdded(added_blobs_);
+        if (!updated_blobs_.isEmpty())
+            emit blobsUpdated(updated_blobs_);
+        if (!frame.removedBlobs().isEmpty())
+            emit blobsRemoved(frame.removedBlobs());
+        break;
     }
+}
+
+void QTuioHandler::selectSource(const QOscMessageView &message)
+{
+    // "source name@address", sent in every bundle before the ALIVE message
+    source_name_ = message.stringAt(1);
+    source_ = findSource();
+}
 
-    if (QMetaType::Type(arguments.at(1).type()) != QMetaType::Int ||
-            QMetaType::Type(arguments.at(2).type()) != QMetaType::Int ||
-            QMetaType::Type(arguments.at(3).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(4).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(5).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(6).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(7).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(8).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(9).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(10).type()) != QMetaType::Float) {
-        qWarning() << "Ignoring malformed TUIO set message with bad types: " << arguments;
+void QTuioHandler::process2DCurSource(const QOscMessageView &message)
+{
+    if (message.argumentCount() != 2) {
+        qWarning() << "Ignoring malformed TUIO source message: " << message.argumentCount();
         return;
     }
 
-    int id = arguments.at(1).toInt();
-    int class_id = arguments.at(2).toInt();
-    float x = arguments.at(3).toFloat();
-    float y = arguments.at(4).toFloat();
-    float angle = arguments.at(5).toFloat();
-    float vx = arguments.at(6).toFloat();
-    float vy = arguments.at(7).toFloat();
-    float angular_velocity = arguments.at(8).toFloat();
-    float acceleration = arguments.at(9).toFloat();
-    float angular_acceleration = arguments.at(10).toFloat();
-
-    QMap<int, QTuioToken>::Iterator it = active_tokens_.find(id);
-    if (it == active_tokens_.end()) {
-        qWarning() << "Ignoring malformed TUIO set for nonexistent token " << class_id;
+    if (message.typeAt(1) != 's') {
+        qWarning("Ignoring malformed TUIO source message (bad argument type)");
         return;
     }
 
-    QTuioToken &tok = *it;
-    tok.setClassId(class_id);
-    tok.setX(x);
-    tok.setY(y);
-    tok.setVX(vx);
-    tok.setVY(vy);
-    tok.setAcceleration(acceleration);
-    tok.setAngle(angle);
-    tok.setAngularVelocity(angular_velocity);
-    tok.setAngularAcceleration(angular_acceleration);
+    selectSource(message);
 }
 
-void QTuioHandler::process2DObjFseq(const QOscMessage &message)
+void QTuioHandler::process2DCurAlive(const QOscMessageView &message)
 {
-    Q_UNUSED(message);
+    // delta the notified cursors that are active, against the ones we already
+    // know of. The result is only staged, the FSEQ ending the frame commits
+    // it.
+    if (!readAliveIds(message, alive_ids_))
+        return;
 
-    emit tokenEvent(active_tokens_, dead_tokens_);
-    dead_tokens_.clear();
+    checkStagedFrame(QTuio2DCurProfile, source_->cursors.releasedCount());
+    source_->cursors.setAlive(alive_ids_.data(), alive_ids_.size());
 }
 
-void QTuioHandler::process2DBlbSource(const QOscMessage &message)
+void QTuioHandler::process2DCurSet(const QOscMessageView &message)
 {
-
-    QList<QVariant> arguments = message.arguments();
-    if (arguments.count() != 2) {
-        qWarning() << "Ignoring malformed TUIO source message: " << arguments.count();
+    QTuioSetDecoder<QTuioCursor> set(message);
+    if (!set.isValid()) {
+        qWarning() << "Ignoring malformed TUIO set message with bad types: " << message.typeTags();
         return;
     }
 
-    if (QMetaType::Type(arguments.at(1).type()) != QMetaType::QByteArray) {
-        qWarning("Ignoring malformed TUIO source message (bad argument type)");
+    int cursor_id = set.id();
+    QTuioCursor *cursor = source_->cursors.find(cursor_id);
+    if (!cursor) {
+        qWarning() << "Ignoring malformed TUIO set for nonexistent cursor " << cursor_id;
         return;
     }
+
+    set.apply(*cursor);
 }
 
 
-void QTuioHandler::process2DBlbAlive(const QOscMessage &message)
+void QTuioHandler::process2DCurFseq(const QOscMessageView &message)
 {
-    QList<QVariant> arguments = message.arguments();
-
+    if (acceptFrame(QTuio2DCurProfile, readFseq(message)))
+        commitStagedFrame(QTuio2DCurProfile);
+    else
+        discardStagedFrame(QTuio2DCurProfile);
+}
 
-    QMap<int, QTuioBlob> old_active_blobs = active_bobs_;
-    QMap<int, QTuioBlob> new_active_blobs;
+void QTuioHandler::process2DObjSource(const QOscMessageView &message)
+{
+    if (message.argumentCount() != 2) {
+        qWarning() << "Ignoring malformed TUIO source message: " << message.argumentCount();
+        return;
+    }
 
-    for( int i = 1; i < arguments.count(); ++i) {
-        if (QMetaType::Type(arguments.at(i).type()) != QMetaType::Int) {
-            qWarning() << "Ignoring malformed TUIO alive message (bad argument on position" << i << arguments << ')';
-            return;
-        }
+    if (message.typeAt(1) != 's') {
+        qWarning("Ignoring malformed TUIO source message (bad argument type)");
+        return;
+    }
 
-        int session_id = arguments.at(i).toInt();
-        if (!old_active_blobs.contains(session_id)) {
-            QTuioBlob blob(session_id);
-            blob.setState(Qt::TouchPointPressed);
-            new_active_blobs.insert(session_id, blob);
-        } else {
-            QTuioBlob blob = old_active_blobs.value(session_id);
-            blob.setState(Qt::TouchPointStationary); // position change in SET will update if needed
-            new_active_blobs.insert(session_id, blob);
-            old_active_blobs.remove(session_id);
+    selectSource(message);
+}
 
-        }
-    }
+void QTuioHandler::process2DObjAlive(const QOscMessageView &message)
+{
+    // delta the notified tokens that are active, against the ones we already
+    // know of. The result is only staged, the FSEQ ending the frame commits
+    // it.
+    if (!readAliveIds(message, alive_ids_))
+        return;
 
-    QMap<int, QTuioBlob>::ConstIterator it = old_active_blobs.constBegin();
+    checkStagedFrame(QTuio2DObjProfile, source_->tokens.releasedCount());
+    source_->tokens.setAlive(alive_ids_.data(), alive_ids_.size());
+}
 
-    dead_bobs_.reserve(old_active_blobs.size());
+void QTuioHandler::process2DObjSet(const QOscMessageView &message)
+{
+    QTuioSetDecoder<QTuioToken> set(message);
+    if (!set.isValid()) {
+        qWarning() << "Ignoring malformed TUIO set message with bad types: " << message.typeTags();
+        return;
+    }
 
-    while (it != old_active_blobs.constEnd()) {
-        dead_bobs_.append(it.value());
-        ++it;
+    int id = set.id();
+    QTuioToken *token = source_->tokens.find(id);
+    if (!token) {
+        qWarning() << "Ignoring malformed TUIO set for nonexistent token " << id;
+        return;
     }
 
-    active_bobs_ = new_active_blobs;
+    set.apply(*token);
 }
 
-void QTuioHandler::process2DBlbSet(const QOscMessage &message)
+void QTuioHandler::process2DObjFseq(const QOscMessageView &message)
 {
+    if (acceptFrame(QTuio2DObjProfile, readFseq(message)))
+        commitStagedFrame(QTuio2DObjProfile);
+    else
+        discardStagedFrame(QTuio2DObjProfile);
+}
 
-    QList<QVariant> arguments = message.arguments();
-    if (arguments.count() < 7) {
-        qWarning() << "Ignoring malformed TUIO set message with too few arguments: " << arguments.count();
+void QTuioHandler::process2DBlbSource(const QOscMessageView &message)
+{
+    if (message.argumentCount() != 2) {
+        qWarning() << "Ignoring malformed TUIO source message: " << message.argumentCount();
         return;
     }
 
-    if (QMetaType::Type(arguments.at(1).type()) != QMetaType::Int ||
-            QMetaType::Type(arguments.at(2).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(3).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(4).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(5).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(6).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(7).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(8).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(9).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(10).type()) != QMetaType::Float ||
-            QMetaType::Type(arguments.at(11).type()) != QMetaType::Float) {
-        qWarning() << "Ignoring malformed TUIO set message with bad types: " << arguments;
+    if (message.typeAt(1) != 's') {
+        qWarning("Ignoring malformed TUIO source message (bad argument type)");
         return;
     }
 
-    int id = arguments.at(1).toInt();
-    float x = arguments.at(2).toFloat();
-    float y = arguments.at(3).toFloat();
-    float angle = arguments.at(4).toFloat();
-    float width = arguments.at(5).toFloat();
-    float height = arguments.at(6).toFloat();
-    float vx = arguments.at(7).toFloat();
-    float vy = arguments.at(8).toFloat();
-    float vr = arguments.at(9).toFloat();
-    float macc = arguments.at(10).toFloat();
-    float racc = arguments.at(11).toFloat();
-
-    QMap<int, QTuioBlob>::Iterator it = active_bobs_.find(id);
-    if (it == active_bobs_.end()) {
+    selectSource(message);
+}
+
+
+void QTuioHandler::process2DBlbAlive(const QOscMessageView &message)
+{
+    if (!readAliveIds(message, alive_ids_))
+        return;
+
+    checkStagedFrame(QTuio2DBlbProfile, source_->blobs.releasedCount());
+    source_->blobs.setAlive(alive_ids_.data(), alive_ids_.size());
+}
+
+void QTuioHandler::process2DBlbSet(const QOscMessageView &message)
+{
+    QTuioSetDecoder<QTuioBlob> set(message);
+    if (!set.isValid()) {
+        qWarning() << "Ignoring malformed TUIO set message with bad types: " << message.typeTags();
+        return;
+    }
+
+    int id = set.id();
+    QTuioBlob *blob = source_->blobs.find(id);
+    if (!blob) {
         qWarning() << "Ignoring malformed TUIO set for nonexistent blob " << id;
         return;
     }
 
-    QTuioBlob &blb = *it;
-    blb.setX(x);
-    blb.setY(y);
-    blb.setAngle(angle);
-    blb.setWidth(width);
-    blb.setHeight(height);
-    blb.setVX(vx);
-    blb.setVY(vy);
-    blb.setVR(vr);
-    blb.setAcceleration(macc);
-    blb.setRotationAcceleration(racc);
+    set.apply(*blob);
 }
 
-void QTuioHandler::process2DBlbFseq(const QOscMessage &message)
+void QTuioHandler::process2DBlbFseq(const QOscMessageView &message)
 {
-    Q_UNUSED(message);
-
-    emit blobEvent(active_bobs_, dead_bobs_);
-    dead_bobs_.clear();
+    if (acceptFrame(QTuio2DBlbProfile, readFseq(message)))
+        commitStagedFrame(QTuio2DBlbProfile);
+    else
+        discardStagedFrame(QTuio2DBlbProfile);
 }
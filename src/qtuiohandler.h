@@ -1,61 +1,315 @@
 #ifndef QQTuioHandler_H
 #define QQTuioHandler_H
 
+#include <QAtomicInt>
+#include <QMutex>
 #include <QObject>
-#include <QMap>
+#include <QScopedPointer>
+#include <QThread>
 #include <QUdpSocket>
 #include <QVector>
 
 #include "qtuiocursor_p.h"
 #include "qtuiotoken_p.h"
-#include "qoscbundle_p.h"
-#include "qoscmessage_p.h"
+#include "qoscmessageview_p.h"
+#include "qoscpatternmatcher_p.h"
 #include "qtuioblob_p.h"
+#include "qtuioframe.h"
+#include "qtuioframepool_p.h"
+#include "qtuiointerpolator_p.h"
+#include "qtuiojitterbuffer_p.h"
+#include "qtuiopredictor_p.h"
+#include "qtuiosessionfilter_p.h"
+#include "qtuiosessionset_p.h"
+#include "qtuioslotallocator_p.h"
+#include "qtuiosource_p.h"
+#include "qtuiospscring_p.h"
+#include "qtuiotriplebuffer_p.h"
 #include "udp_client.h"
 
+class QTimer;
+class QUdpBatchReceiver;
+
 class QTuioHandler : public QObject
 {
     Q_OBJECT
 public:
+    struct Options
+    {
+        enum Backend {
+            UdpClientBackend,
+            // Linux only, elsewhere UdpClient is used instead
+            RecvmmsgBackend
+        };
+
+        Options()
+            : threaded(false)
+            , frameQueueSize(64)
+            , backend(UdpClientBackend)
+            , receiveBufferSize(1 << 20)
+            , receiveBatchSize(16)
+            , mergeSources(false)
+            , maxSources(16)
+            , sourceTimeout(5000)
+            , maxPendingAliveCycles(8)
+            , maxDeadEntries(4096)
+            , maxStaleness(250)
+            , jitterBuffer(false)
+            , jitterBufferSize(32)
+            , maxJitterDelay(50)
+            , maxPrediction(100)
+            , recycleFrames(false)
+            , coalesceFrames(false)
+        {
+        }
+
+        // receive, parse and assemble frames on a dedicated thread, so a
+        // busy consumer thread can't hold up reading the socket. Frames are
+        // handed to the thread the handler lives in through a lock-free
+        // ring of frameQueueSize frames, and the signals are emitted there.
+        bool threaded;
+        int frameQueueSize;
+
+        // how datagrams are read. The recvmmsg backend reads up to
+        // receiveBatchSize datagrams per syscall into preallocated buffers,
+        // asks for a receiveBufferSize byte SO_RCVBUF (0 keeps the system
+        // default) and stamps datagrams with their kernel arrival time.
+        Backend backend;
+        int receiveBufferSize;
+        int receiveBatchSize;
+
+        // every tracker, told apart by its sender endpoint and SOURCE name,
+        // gets its own sessions and frames, tagged with QTuioFrame::sourceId().
+        // With mergeSources, frames instead carry the sessions of all
+        // sources at once, with IDs made unique across them. Datagrams from
+        // more than maxSources (at most 128) sources are ignored. A source
+        // not heard from for sourceTimeout milliseconds (0 for never) is
+        // dropped: a synthesized frame releases its sessions, and its ID is
+        // reused for the next new source.
+        bool mergeSources;
+        int maxSources;
+        int sourceTimeout;
+
+        // a frame staged by ALIVE is normally committed by its FSEQ. For
+        // senders that drop or never send FSEQ, the next ALIVE commits it
+        // anyway, SETs and all, once maxPendingAliveCycles ALIVEs arrived
+        // without one, once it releases more than maxDeadEntries sessions,
+        // or once it has waited for maxStaleness milliseconds. See
+        // QTuioFrame::isSynthesized() and forcedFlushCount().
+        int maxPendingAliveCycles;
+        int maxDeadEntries;
+        int maxStaleness;
+
+        // hold frames back to emit them at the pace the tracker sent them,
+        // rather than in the clumps the network may deliver them in. The
+        // delay adapts to the jitter measured, but never exceeds
+        // maxJitterDelay milliseconds, and at most jitterBufferSize frames
+        // are held at a time.
+        bool jitterBuffer;
+        int jitterBufferSize;
+        int maxJitterDelay;
+
+        // predictedFrame() extrapolates at most this many milliseconds ahead
+        int maxPrediction;
+
+        // smooth the jitter out of positions and angles, with a One Euro or
+        // a Kalman filter per session, before they go into frames
+        QTuioFilterParameters filter;
+
+        // build frames in buffers recycled once every frame made from them
+        // was let go of, copying the sessions into the storage they already
+        // have. Once warmed up, receiving with the recvmmsg backend, parsing,
+        // diffing and emitting a frame to direct connections then allocates
+        // nothing. Queued connections, the threaded mode's wake-up call and
+        // the jitter buffer's timer still do, inside Qt.
+        bool recycleFrames;
+
+        // emit frames once the event loop gets to them rather than right
+        // away, and of the frames of a source and profile that piled up by
+        // then only the newest, standing in for the ones before it: sessions
+        // are pressed, moved or removed relative to the frame emitted last.
+        // A consumer busy for longer than the tracker's frame interval then
+        // catches up in one go instead of falling further behind.
+        bool coalesceFrames;
+    };
+
     explicit QTuioHandler(QObject *parent = nullptr);
     explicit QTuioHandler(const QHostAddress& ip, unsigned port, QObject *parent = nullptr);
+    QTuioHandler(const QHostAddress& ip, unsigned port, const Options &options, QObject *parent = nullptr);
     virtual ~QTuioHandler();
 
+    typedef QOscPatternDispatcher::Handler MessageHandler;
+
+    // Registers \a handler for every message whose address matches the OSC
+    // pattern \a pattern, e.g. "/tuio/*cur" or "/tuio/_*" for vendor
+    // profiles. Returns an ID for removeMessageHandler(), or -1 if the
+    // pattern is malformed. Handlers are called on the thread datagrams are
+    // parsed on, which is the ingest thread in threaded mode, and may add or
+    // remove handlers, which then takes effect from the next message.
+    int addMessageHandler(const QByteArray &pattern, const MessageHandler &handler);
+    void removeMessageHandler(int id);
+
+    // The latest emitted frame, with every session extrapolated to
+    // \a targetTime (in ns since the epoch, like QTuioFrame::arrivalTime()),
+    // e.g. the next display refresh, using the velocities and accelerations
+    // the tracker sends. The first one is of the source that sent the latest
+    // frame, the second of \a sourceId, or of all of them merged for -1.
+    // Call on the thread the handler lives in.
+    QTuioFrame predictedFrame(qint64 targetTime) const;
+    QTuioFrame predictedFrame(qint64 targetTime, int sourceId) const;
+
+    // A frame in between the latest two emitted frames, with the sessions
+    // moved to where they were at \a time, for consumers rendering faster
+    // than the tracker runs. Rendering one frame interval in the past keeps
+    // \a time in between; later times get the latest frame as it is. The
+    // frames are recycled once released, so hold on to them only for as long
+    // as it takes to render one. Call on the thread the handler lives in.
+    QTuioFrame interpolatedFrame(qint64 time);
+    QTuioFrame interpolatedFrame(qint64 time, int sourceId);
+
+    // The newest committed frame, of whichever source committed last,
+    // straight from the thread frames are assembled on: ahead of the jitter
+    // buffer, coalescing and the signals. Wait-free, for a render loop
+    // polling once per display refresh; call from one thread at a time.
+    QTuioFrame latestFrame() { return latest_frame_.read(); }
+
+    // how many frames were committed without an FSEQ, see Options
+    int forcedFlushCount() const { return forced_flushes_.loadAcquire(); }
+
 signals:
-    void cursorEvent(const QMap<int, QTuioCursor>& active_cursors,
+    // emitted for every committed frame, before the per-profile signals below
+    void frameReady(const QTuioFrame& frame);
+
+    // active sessions are sorted by session ID. With coalesceFrames, a
+    // dead session may have handed its slot on to an active one that was
+    // pressed since, so consumers keyed by slot handle the dead ones first.
+    void cursorEvent(const QVector<QTuioCursor>& active_cursors,
                      const QVector<QTuioCursor>& dead_cursors);
-    void tokenEvent(QMap<int, QTuioToken> active_token, QVector<QTuioToken> dead_token);
-    void blobEvent(QMap<int, QTuioBlob> active_token, QVector<QTuioBlob> dead_token);
+    void tokenEvent(const QVector<QTuioToken>& active_token, const QVector<QTuioToken>& dead_token);
+    void blobEvent(const QVector<QTuioBlob>& active_token, const QVector<QTuioBlob>& dead_token);
+
+    // emitted after the full snapshot, with only what changed since
+    // the previous frame, and only if something did
+    void cursorsAdded(const QVector<QTuioCursor>& cursors);
+    void cursorsUpdated(const QVector<QTuioCursor>& cursors);
+    void cursorsRemoved(const QVector<QTuioCursor>& cursors);
+    void tokensAdded(const QVector<QTuioToken>& tokens);
+    void tokensUpdated(const QVector<QTuioToken>& tokens);
+    void tokensRemoved(const QVector<QTuioToken>& tokens);
+    void blobsAdded(const QVector<QTuioBlob>& blobs);
+    void blobsUpdated(const QVector<QTuioBlob>& blobs);
+    void blobsRemoved(const QVector<QTuioBlob>& blobs);
 
 public slots:
     void processPackets(const QByteArray&, const QHostAddress&, unsigned);
+    // \a arrival_ns is when the datagram arrived, in nanoseconds since the epoch
+    void processDatagram(const char *data, int size, const QHostAddress &sender,
+                         unsigned sender_port, qint64 arrival_ns);
+
+private slots:
+    void deliverQueuedFrames();
+    void releaseBufferedFrames();
 
-    void process2DCurSource(const QOscMessage &message);
-    void process2DCurAlive(const QOscMessage &message);
-    void process2DCurSet(const QOscMessage &message);
-    void process2DCurFseq(const QOscMessage &message);
+protected:
+    void startReceiving(const QHostAddress &ip, unsigned port, const Options &options);
+    void stopReceiving();
+    void processMessage(const QOscMessageView &message);
 
-    void process2DObjSource(const QOscMessage &message);
-    void process2DObjAlive(const QOscMessage &message);
-    void process2DObjSet(const QOscMessage &message);
-    void process2DObjFseq(const QOscMessage &message);
+    // called by processMessage() only, with the message's source selected
+    void process2DCurSource(const QOscMessageView &message);
+    void process2DCurAlive(const QOscMessageView &message);
+    void process2DCurSet(const QOscMessageView &message);
+    void process2DCurFseq(const QOscMessageView &message);
 
-    void process2DBlbSource(const QOscMessage &message);
-    void process2DBlbAlive(const QOscMessage &message);
-    void process2DBlbSet(const QOscMessage &message);
-    void process2DBlbFseq(const QOscMessage &message);
+    void process2DObjSource(const QOscMessageView &message);
+    void process2DObjAlive(const QOscMessageView &message);
+    void process2DObjSet(const QOscMessageView &message);
+    void process2DObjFseq(const QOscMessageView &message);
 
-protected:
+    void process2DBlbSource(const QOscMessageView &message);
+    void process2DBlbAlive(const QOscMessageView &message);
+    void process2DBlbSet(const QOscMessageView &message);
+    void process2DBlbFseq(const QOscMessageView &message);
+
+    void selectSource(const QOscMessageView &message);
+    QTuioSource *findSource();
+    void expireSources(qint64 now);
+    void releaseSource(QTuioSource *source);
+    int findStaleProfiles(const char *data, int size);
+    bool acceptFrame(int profile, qint32 fseq);
+    void checkStagedFrame(int profile, int released);
+    void commitStagedFrame(int profile, bool synthesized = false);
+    void discardStagedFrame(int profile);
+    QTuioFrameData *newFrameData(int profile);
+    void commitFrame(const QTuioFrame &frame);
+    QTuioFrame coalescedFrame(const QTuioFrame &previous, const QTuioFrame &latest);
+    void scheduleFrame(const QTuioFrame &frame);
+    void deliverFrame(const QTuioFrame &frame);
 
     UdpClient *client_;
-    QMap<int, QTuioCursor> active_cursors_;
-    QVector<QTuioCursor> dead_cursors_;
+    QUdpBatchReceiver *receiver_;
+    QThread *ingest_thread_;
+    QScopedPointer<QTuioSpscRing<QTuioFrame> > frame_queue_;
+    QAtomicInt delivery_pending_;
+    QTuioFrame queued_frame_;
+    QScopedPointer<QTuioJitterBuffer> jitter_buffer_;
+    QTimer *jitter_timer_;
+    QTuioFrame buffered_frame_;
+    QScopedPointer<QTuioFramePool> frame_pool_;
+    QTuioTripleBuffer<QTuioFrame> latest_frame_;
+
+    // per source and profile, for coalesceFrames
+    struct Coalescing
+    {
+        Coalescing() : count(0) {}
+        QTuioFrame emitted; // the last frame emitted
+        QTuioFrame latest; // the newest of the count frames since
+        int count;
+    };
+    bool coalesce_frames_;
+    QVector<Coalescing> coalescing_;
+    QScopedPointer<QTuioFramePool> coalesce_pool_;
+    QTuioPredictor predictor_;
+    QTuioInterpolator interpolator_;
+    qint64 arrival_ns_;
+    quint64 time_tag_; // of the datagram's outermost bundle
+
+    QMutex pattern_mutex_;
+    QOscPatternDispatcher pattern_dispatcher_;
+    QAtomicInt pattern_handlers_; // so messages skip the mutex while there are none
+    QVector<int> alive_ids_;
+
+    bool merge_sources_;
+    int max_sources_;
+    QVector<QTuioSource *> sources_; // sorted by ID
+    QTuioSlotAllocator source_ids_;
+    qint64 source_timeout_ns_;
+    QTimer *expiry_timer_; // on the thread datagrams are processed on
+    // the source of the messages being processed, and what identifies it
+    QTuioSource *source_;
+    const QHostAddress *sender_;
+    quint16 sender_port_;
+    QLatin1String source_name_;
+    int stale_profiles_; // bit per QTuioProfile whose frame in the datagram is stale
+
+    int max_pending_alive_;
+    int max_dead_entries_;
+    qint64 max_staleness_ns_;
+    QAtomicInt forced_flushes_;
+    QTuioFilterParameters filter_parameters_;
 
-    QMap<int, QTuioToken> active_tokens_;
-    QVector<QTuioToken> dead_tokens_;
+    // shared by all sources, so slots are unique in merged frames too
+    QTuioSlotAllocator cursor_slots_;
+    QTuioSlotAllocator token_slots_;
+    QTuioSlotAllocator blob_slots_;
 
-    QMap<int, QTuioBlob> active_bobs_;
-    QVector<QTuioBlob> dead_bobs_;
+    // scratch for the delta signals, on the delivering thread
+    QVector<QTuioCursor> added_cursors_;
+    QVector<QTuioCursor> updated_cursors_;
+    QVector<QTuioToken> added_tokens_;
+    QVector<QTuioToken> updated_tokens_;
+    QVector<QTuioBlob> added_blobs_;
+    QVector<QTuioBlob> updated_blobs_;
 };
 
 #endif // QQTuioHandler_H
@@ -0,0 +1,118 @@
+#include "qtuiointerpolator_p.h"
+
+#include "qtuiosessionfilter_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Merges the sessions of \a from and \a to, both sorted by ID, into \a out,
+// \a alpha of the way from one to the other. \a out keeps its capacity.
+template <typename T>
+static void interpolate(const QVector<T> &from, const QVector<T> &to, float alpha, QVector<T> &out)
+{
+    typedef QTuioFilterAngle<T> Angle;
+
+    out.resize(0);
+    int i = 0;
+    int j = 0;
+    while (i < from.size() || j < to.size()) {
+        if (j == to.size() || (i < from.size() && from.at(i).id() < to.at(j).id())) {
+            // released in between
+            if (alpha < 0.5f)
+                out.append(from.at(i));
+            ++i;
+        } else if (i == from.size() || to.at(j).id() < from.at(i).id()) {
+            // appeared in between
+            if (alpha >= 0.5f)
+                out.append(to.at(j));
+            ++j;
+        } else {
+            const T &a = from.at(i++);
+            const T &b = to.at(j++);
+            out.append(b);
+            T &session = out.last();
+            session.setX(a.x() + alpha * (b.x() - a.x()));
+            session.setY(a.y() + alpha * (b.y() - a.y()));
+            if (Angle::Channels > 2) {
+                // the short way round
+                float turn = Angle::get(b) - Angle::get(a);
+                turn -= std::floor(turn + 0.5f);
+                Angle::set(session, Angle::get(a) + alpha * turn);
+            }
+        }
+    }
+}
+
+QTuioInterpolator::QTuioInterpolator(int maxSources)
+    : m_history(maxSources)
+    , m_pool(MaxPoolSize)
+{
+}
+
+void QTuioInterpolator::addFrame(const QTuioFrame &frame)
+{
+    m_history.addFrame(frame);
+}
+
+QTuioFrame QTuioInterpolator::interpolatedFrame(qint64 time, int sourceId)
+{
+    if (!m_history.contains(sourceId))
+        return QTuioFrame();
+
+    // how far along from its previous frame to its latest one every profile
+    // is at \a time
+    float alpha[QTuioProfileCount];
+    bool between = false;
+    for (int profile = 0; profile < QTuioProfileCount; ++profile) {
+        const QTuioFrameHistory::Entry &entry = m_history.at(sourceId, profile);
+        const qint64 from = QTuioFrameHistory::referenceTime(entry.previous);
+        const qint64 to = QTuioFrameHistory::referenceTime(entry.latest);
+        if (!from || to <= from || time >= to) {
+            alpha[profile] = 1;
+        } else {
+            alpha[profile] = time <= from ? 0 : float(time - from) / float(to - from);
+            between = true;
+        }
+    }
+
+    const QTuioFrame &newest = m_history.newest(sourceId);
+    if (!between)
+        return newest;
+
+    const QTuioFrameData &latest = *newest.d;
+    QTuioFrameData *data = m_pool.acquire();
+    data->profile = latest.profile;
+    data->sourceId = latest.sourceId;
+    data->source = latest.source;
+    data->fseq = latest.fseq;
+    data->timestamp = latest.timestamp;
+    data->arrivalTime = latest.arrivalTime;
+    data->synthesized = latest.synthesized;
+    data->timeTag = latest.timeTag;
+    data->trackerTime = latest.trackerTime;
+    data->localTrackerTime = latest.localTrackerTime;
+    data->predictedTime = time;
+
+    // a profile past its latest frame, or without two yet, is as it is in
+    // the newest frame
+    const QTuioFrameHistory::Entry &cursors = m_history.at(sourceId, QTuio2DCurProfile);
+    if (alpha[QTuio2DCurProfile] < 1)
+        interpolate(cursors.previous.cursors(), cursors.latest.cursors(), alpha[QTuio2DCurProfile], data->cursors);
+    else
+        qt_tuioCopySessions(latest.cursors, data->cursors);
+
+    const QTuioFrameHistory::Entry &tokens = m_history.at(sourceId, QTuio2DObjProfile);
+    if (alpha[QTuio2DObjProfile] < 1)
+        interpolate(tokens.previous.tokens(), tokens.latest.tokens(), alpha[QTuio2DObjProfile], data->tokens);
+    else
+        qt_tuioCopySessions(latest.tokens, data->tokens);
+
+    const QTuioFrameHistory::Entry &blobs = m_history.at(sourceId, QTuio2DBlbProfile);
+    if (alpha[QTuio2DBlbProfile] < 1)
+        interpolate(blobs.previous.blobs(), blobs.latest.blobs(), alpha[QTuio2DBlbProfile], data->blobs);
+    else
+        qt_tuioCopySessions(latest.blobs, data->blobs);
+
+    return QTuioFrame(data);
+}
+
+QT_END_NAMESPACE
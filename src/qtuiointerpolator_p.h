@@ -0,0 +1,51 @@
+#ifndef QTUIOINTERPOLATOR_P_H
+#define QTUIOINTERPOLATOR_P_H
+
+#include <QtCore/QVector>
+
+#include "qtuioframe.h"
+#include "qtuioframehistory_p.h"
+#include "qtuioframepool_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Produces frames in between the last two frames of a source, for any
+    time the consumer renders at, so sessions move smoothly on displays
+    refreshing faster than the tracker runs. Each profile goes by the last
+    two frames it committed itself.
+
+    Sessions in both frames move linearly from one position (and angle) to
+    the other. Sessions only in one of them, that appeared or were released
+    in between, are in the interpolated frame if it is closer to the frame
+    they are in.
+
+    Interpolated frames are built in a small pool of frame buffers. A buffer
+    is reused once the consumer has let go of the frame it held, so in steady
+    state interpolating allocates nothing.
+*/
+class QTuioInterpolator
+{
+public:
+    explicit QTuioInterpolator(int maxSources);
+
+    // called with every emitted frame
+    void addFrame(const QTuioFrame &frame);
+
+    int lastSourceId() const { return m_history.lastSourceId(); }
+
+    // \a time is in ns, on the clock of QTuioFrame::arrivalTime()
+    QTuioFrame interpolatedFrame(qint64 time, int sourceId);
+
+private:
+    QTuioFrameHistory m_history;
+
+    enum { MaxPoolSize = 8 };
+    QTuioFramePool m_pool;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOINTERPOLATOR_P_H
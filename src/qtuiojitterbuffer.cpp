@@ -0,0 +1,96 @@
+#include "qtuiojitterbuffer_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// a discontinuity this large is a tracker restarting, or resuming after a
+// pause, not jitter
+static const qint64 ResyncThreshold = Q_INT64_C(1000000000);
+
+// the playout delay, in multiples of the jitter
+enum { JitterMultiple = 3 };
+
+void QTuioJitterBuffer::SourceState::reset()
+{
+    valid = false;
+    lastFseq = -1;
+    lastArrival = 0;
+    lastMediaTime = 0;
+    period = 0;
+    jitter = 0;
+    clock = QTuioClockSync();
+}
+
+QTuioJitterBuffer::QTuioJitterBuffer(int capacity, int maxSources, qint64 maxDelay)
+    : m_mask(1)
+    , m_head(0)
+    , m_tail(0)
+    , m_maxDelay(maxDelay)
+    , m_lastRelease(0)
+{
+    while (int(m_mask) < capacity)
+        m_mask <<= 1;
+    m_entries.resize(int(m_mask));
+    --m_mask;
+
+    m_sources.resize((maxSources + 1) * QTuioProfileCount);
+}
+
+// The time \a frame was produced at, on a per source timeline.
+qint64 QTuioJitterBuffer::mediaTime(SourceState &state, const QTuioFrame &frame) const
+{
+    if (frame.trackerTime())
+        return frame.trackerTime();
+
+    // without time tags, assume the tracker runs at a steady rate, and
+    // count the frames lost in between from the FSEQ gap
+    if (!state.valid)
+        return frame.arrivalTime();
+
+    const qint32 gap = frame.fseq() - state.lastFseq;
+    const int steps = gap > 0 && gap <= 16 ? gap : 1;
+    const qint64 interval = (frame.arrivalTime() - state.lastArrival) / steps;
+    state.period = state.period ? state.period + (interval - state.period) / 16 : interval;
+    return state.lastMediaTime + state.period * steps;
+}
+
+void QTuioJitterBuffer::push(const QTuioFrame &frame)
+{
+    SourceState &state = m_sources[(frame.sourceId() + 1) * QTuioProfileCount + frame.d->profile];
+    const qint64 arrival = frame.arrivalTime();
+    qint64 media = mediaTime(state, frame);
+
+    if (state.valid) {
+        const qint64 difference = (arrival - state.lastArrival) - (media - state.lastMediaTime);
+        if (qAbs(difference) > ResyncThreshold) {
+            state.reset();
+            media = frame.trackerTime() ? frame.trackerTime() : arrival;
+        } else {
+            state.jitter += (qAbs(difference) - state.jitter) / 16;
+        }
+    }
+
+    state.valid = true;
+    state.lastFseq = frame.fseq();
+    state.lastArrival = arrival;
+    state.lastMediaTime = media;
+    state.clock.addSample(media, arrival);
+
+    // never before the frame arrived, nor later than the cap allows, and
+    // never ahead of a frame scheduled before it. The last one was capped
+    // by an earlier arrival, so keeping the order can't break the cap.
+    qint64 release = state.clock.toLocal(media) + qMin(m_maxDelay, JitterMultiple * state.jitter);
+    release = qBound(arrival, release, arrival + m_maxDelay);
+    release = qMax(release, m_lastRelease);
+    m_lastRelease = release;
+
+    Entry &entry = m_entries[int(m_tail++ & m_mask)];
+    entry.frame = frame;
+    entry.releaseTime = release;
+}
+
+void QTuioJitterBuffer::pop(QTuioFrame &frame)
+{
+    qSwap(frame, m_entries[int(m_head++ & m_mask)].frame);
+}
+
+QT_END_NAMESPACE
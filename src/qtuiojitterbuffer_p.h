@@ -0,0 +1,85 @@
+#ifndef QTUIOJITTERBUFFER_P_H
+#define QTUIOJITTERBUFFER_P_H
+
+#include <QtCore/QVector>
+
+#include "qtuioclocksync_p.h"
+#include "qtuiodispatch_p.h"
+#include "qtuioframe.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Holds committed frames back just long enough to release them at the pace
+    the tracker produced them, instead of in the clumps the network
+    delivers them in.
+
+    Each frame gets a release time: when it would have arrived with the
+    smallest transit delay seen recently, plus a playout delay of a few
+    times the measured jitter. The delay adapts to the jitter of each profile
+    of each source separately (trackers commit their profiles a fraction of
+    a millisecond apart, with the same FSEQ), but a frame is never held for
+    more than maxDelay past its arrival. Frames are timed by their tracker
+    time when bundles carry time tags, and otherwise by a frame clock
+    ticking at the average frame interval, advanced by the FSEQ gaps.
+
+    Frames are kept in a fixed ring, in release order, and scheduling one is
+    constant time; nothing is allocated after construction. All times are in
+    nanoseconds, on the clock of QTuioFrame::arrivalTime().
+*/
+class QTuioJitterBuffer
+{
+public:
+    QTuioJitterBuffer(int capacity, int maxSources, qint64 maxDelay);
+
+    bool isEmpty() const { return m_head == m_tail; }
+    bool isFull() const { return m_tail - m_head > m_mask; }
+
+    // the ring must not be full
+    void push(const QTuioFrame &frame);
+    // when the first frame is due, the ring must not be empty
+    qint64 nextReleaseTime() const { return m_entries.at(int(m_head & m_mask)).releaseTime; }
+    // takes the first frame, due or not
+    void pop(QTuioFrame &frame);
+
+private:
+    struct Entry
+    {
+        Entry() : releaseTime(0) {}
+
+        QTuioFrame frame;
+        qint64 releaseTime;
+    };
+
+    struct SourceState
+    {
+        SourceState() { reset(); }
+        void reset();
+
+        bool valid;
+        qint32 lastFseq;
+        qint64 lastArrival;
+        qint64 lastMediaTime;
+        qint64 period; // average frame interval, for untagged frames
+        qint64 jitter; // RFC 3550 style interarrival jitter
+        QTuioClockSync clock;
+    };
+
+    qint64 mediaTime(SourceState &state, const QTuioFrame &frame) const;
+
+    QVector<Entry> m_entries;
+    quint32 m_mask;
+    quint32 m_head;
+    quint32 m_tail;
+
+    // per (source, profile); source -1, the merged one, comes first
+    QVector<SourceState> m_sources;
+    qint64 m_maxDelay;
+    qint64 m_lastRelease;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOJITTERBUFFER_P_H
@@ -0,0 +1,168 @@
+#include "qtuiopredictor_p.h"
+
+#include <QtCore/QVarLengthArray>
+
+#include <algorithm>
+#include <cmath>
+
+#include "qtuiosessionfilter_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// velocities are only estimated from frames closer together than this, in s
+static const float MaxEstimateInterval = 0.25f;
+// nor from frames closer than a tracker frame: merged frames of one profile
+// can be committed by different sources moments apart
+static const float MinEstimateInterval = 0.002f;
+
+// Positions are normalized to 0..1, rotation speeds are in turns per second
+// (and turns per second squared), as the TUIO reference implementation
+// sends them.
+struct QTuioKinematics
+{
+    explicit QTuioKinematics(int count)
+        : x(count), y(count), vx(count), vy(count), acceleration(count)
+    {
+    }
+
+    QVarLengthArray<float, 64> x;
+    QVarLengthArray<float, 64> y;
+    QVarLengthArray<float, 64> vx;
+    QVarLengthArray<float, 64> vy;
+    QVarLengthArray<float, 64> acceleration;
+};
+
+template <typename T>
+static void gather(const QVector<T> &sessions, const QVector<T> &previous, float interval, QTuioKinematics &k)
+{
+    // both lists are sorted by ID, so finding the previous position of every
+    // session is one merge
+    int j = 0;
+    for (int i = 0; i < sessions.size(); ++i) {
+        const T &session = sessions.at(i);
+        k.x[i] = session.x();
+        k.y[i] = session.y();
+        k.vx[i] = session.vx();
+        k.vy[i] = session.vy();
+        k.acceleration[i] = session.acceleration();
+
+        if (k.vx[i] != 0 || k.vy[i] != 0 || interval <= 0)
+            continue;
+        while (j < previous.size() && previous.at(j).id() < session.id())
+            ++j;
+        if (j < previous.size() && previous.at(j).id() == session.id()) {
+            k.vx[i] = (k.x[i] - previous.at(j).x()) / interval;
+            k.vy[i] = (k.y[i] - previous.at(j).y()) / interval;
+        }
+    }
+}
+
+static void extrapolate(QTuioKinematics &k, int count, float dt)
+{
+    // move along the direction of motion, by the distance the speed and
+    // acceleration cover in dt. Decelerating stops, it doesn't reverse.
+    for (int i = 0; i < count; ++i) {
+        const float speed = std::sqrt(k.vx[i] * k.vx[i] + k.vy[i] * k.vy[i]);
+        const float distance = std::max(0.0f, speed * dt + 0.5f * k.acceleration[i] * dt * dt);
+        const float scale = speed > 0.0f ? distance / speed : 0.0f;
+        k.x[i] = std::min(1.0f, std::max(0.0f, k.x[i] + k.vx[i] * scale));
+        k.y[i] = std::min(1.0f, std::max(0.0f, k.y[i] + k.vy[i] * scale));
+    }
+}
+
+template <typename T>
+static void scatter(QVector<T> &sessions, const QTuioKinematics &k)
+{
+    T *session = sessions.data();
+    for (int i = 0; i < sessions.size(); ++i) {
+        session[i].setX(k.x[i]);
+        session[i].setY(k.y[i]);
+    }
+}
+
+template <typename T>
+static void predictPositions(QVector<T> &sessions, const QVector<T> &previous, float interval, float dt)
+{
+    const int count = sessions.size();
+    if (!count)
+        return;
+
+    QTuioKinematics k(count);
+    gather(sessions, previous, interval, k);
+    extrapolate(k, count, dt);
+    scatter(sessions, k);
+}
+
+// turns by the rotation speed and acceleration, wrapping like a received
+// angle
+template <typename T, typename Speed, typename Acceleration>
+static void predictAngles(QVector<T> &sessions, Speed speed, Acceleration acceleration, float dt)
+{
+    typedef QTuioFilterAngle<T> Angle;
+
+    T *session = sessions.data();
+    for (int i = 0; i < sessions.size(); ++i) {
+        const float turns = (session[i].*speed)() * dt + 0.5f * (session[i].*acceleration)() * dt * dt;
+        Angle::set(session[i], Angle::get(session[i]) + turns);
+    }
+}
+
+QTuioPredictor::QTuioPredictor(int maxSources, qint64 maxLookahead)
+    : m_history(maxSources)
+    , m_maxLookahead(maxLookahead)
+{
+}
+
+void QTuioPredictor::addFrame(const QTuioFrame &frame)
+{
+    m_history.addFrame(frame);
+}
+
+QTuioFrame QTuioPredictor::predictedFrame(qint64 targetTime, int sourceId) const
+{
+    if (!m_history.contains(sourceId))
+        return QTuioFrame();
+
+    const QTuioFrame &newest = m_history.newest(sourceId);
+    const qint64 reference = QTuioFrameHistory::referenceTime(newest);
+    if (!reference)
+        return newest;
+
+    QTuioFrameData *data = new QTuioFrameData(*newest.d);
+    data->predictedTime = reference + qBound(qint64(0), targetTime - reference, m_maxLookahead);
+
+    // every profile is extrapolated from the frames it committed itself
+    for (int profile = 0; profile < QTuioProfileCount; ++profile) {
+        const QTuioFrameHistory::Entry &entry = m_history.at(sourceId, profile);
+        const qint64 committed = QTuioFrameHistory::referenceTime(entry.latest);
+        if (!committed)
+            continue;
+
+        const float dt = float(qBound(qint64(0), targetTime - committed, m_maxLookahead)) / 1e9f;
+        float interval = float(committed - QTuioFrameHistory::referenceTime(entry.previous)) / 1e9f;
+        if (interval > MaxEstimateInterval || interval < MinEstimateInterval)
+            interval = 0;
+
+        const QTuioFrameData &latest = *entry.latest.d;
+        const QTuioFrameData &previous = *entry.previous.d;
+        switch (profile) {
+        case QTuio2DCurProfile:
+            data->cursors = latest.cursors;
+            predictPositions(data->cursors, previous.cursors, interval, dt);
+            break;
+        case QTuio2DObjProfile:
+            data->tokens = latest.tokens;
+            predictPositions(data->tokens, previous.tokens, interval, dt);
+            predictAngles(data->tokens, &QTuioToken::angularVelocity, &QTuioToken::angularAcceleration, dt);
+            break;
+        case QTuio2DBlbProfile:
+            data->blobs = latest.blobs;
+            predictPositions(data->blobs, previous.blobs, interval, dt);
+            predictAngles(data->blobs, &QTuioBlob::vr, &QTuioBlob::rotationAcceleration, dt);
+            break;
+        }
+    }
+    return QTuioFrame(data);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,48 @@
+#ifndef QTUIOPREDICTOR_P_H
+#define QTUIOPREDICTOR_P_H
+
+#include <QtCore/QVector>
+
+#include "qtuioframe.h"
+#include "qtuioframehistory_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Extrapolates the sessions of the latest frame of a source to a later
+    time, to make up for the latency between the camera and the screen.
+
+    Positions move along the velocity the tracker sent, sped up or slowed
+    down by its acceleration; tokens and blobs also turn by their rotation
+    speed and acceleration. Trackers that don't send velocities get them
+    estimated from the positions in the previous frame of the same profile.
+
+    Each profile is predicted as one batch: the kinematics are gathered into
+    flat arrays, extrapolated in a single branch-free loop, and written back.
+*/
+class QTuioPredictor
+{
+public:
+    // \a maxLookahead is in ns
+    QTuioPredictor(int maxSources, qint64 maxLookahead);
+
+    // called with every emitted frame
+    void addFrame(const QTuioFrame &frame);
+
+    int lastSourceId() const { return m_history.lastSourceId(); }
+
+    // the latest frame of \a sourceId, extrapolated to \a targetTime, in ns
+    // on the clock of QTuioFrame::arrivalTime(). Looking further ahead than
+    // maxLookahead is clamped to it.
+    QTuioFrame predictedFrame(qint64 targetTime, int sourceId) const;
+
+private:
+    QTuioFrameHistory m_history;
+    qint64 m_maxLookahead;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOPREDICTOR_P_H
@@ -0,0 +1,152 @@
+#include "qtuiosessionfilter_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// the variance of the rate of a session that just appeared, in screen sizes
+// (or turns) per second, squared
+static const float InitialRateVariance = 1.0f;
+
+// the difference of two angles in turns, or an angle, brought to -0.5..0.5
+static inline float wrapTurns(float turns)
+{
+    return turns - std::floor(turns + 0.5f);
+}
+
+template <bool Wrap>
+static void oneEuro(float *value, float *rate, float *measurement, int count, float dt,
+                    const QTuioFilterParameters &parameters)
+{
+    const float twoPi = float(2 * M_PI);
+    const float rateTau = 1.0f / (twoPi * parameters.derivativeCutoff);
+    const float rateAlpha = dt / (dt + rateTau);
+
+    for (int i = 0; i < count; ++i) {
+        float delta = measurement[i] - value[i];
+        if (Wrap)
+            delta = wrapTurns(delta);
+
+        rate[i] += rateAlpha * (delta / dt - rate[i]);
+        const float cutoff = parameters.minCutoff + parameters.beta * std::fabs(rate[i]);
+        const float alpha = twoPi * cutoff * dt / (1.0f + twoPi * cutoff * dt);
+
+        float filtered = value[i] + alpha * delta;
+        if (Wrap)
+            filtered = wrapTurns(filtered);
+        value[i] = filtered;
+        measurement[i] = filtered;
+    }
+}
+
+template <bool Wrap>
+static void kalman(float *value, float *rate, float *p00, float *p01, float *p11, float *measurement,
+                   int count, float dt, const QTuioFilterParameters &parameters)
+{
+    const float q = parameters.processNoise;
+    const float r = parameters.measurementNoise;
+    const float dt2 = dt * dt;
+    const float dt3 = dt2 * dt;
+
+    for (int i = 0; i < count; ++i) {
+        // predict, moving at constant velocity
+        const float position = value[i] + rate[i] * dt;
+        const float a = p00[i] + dt * (2.0f * p01[i] + dt * p11[i]) + q * dt3 / 3.0f;
+        const float b = p01[i] + dt * p11[i] + q * dt2 / 2.0f;
+        const float c = p11[i] + q * dt;
+
+        // correct with the measurement
+        float innovation = measurement[i] - position;
+        if (Wrap)
+            innovation = wrapTurns(innovation);
+        const float k0 = a / (a + r);
+        const float k1 = b / (a + r);
+
+        float filtered = position + k0 * innovation;
+        if (Wrap)
+            filtered = wrapTurns(filtered);
+        value[i] = filtered;
+        rate[i] += k1 * innovation;
+        p00[i] = (1.0f - k0) * a;
+        p01[i] = (1.0f - k0) * b;
+        p11[i] = c - k1 * b;
+        measurement[i] = filtered;
+    }
+}
+
+// Copies the state of \a from[i] into slot i, or \a init if there is none.
+static void carryOver(QVector<float> &next, const QVector<float> &current, const int *from, int count,
+                      const float *init)
+{
+    next.resize(count);
+    float *out = next.data();
+    const float *in = current.constData();
+    for (int i = 0; i < count; ++i)
+        out[i] = from[i] >= 0 ? in[from[i]] : init[i];
+}
+
+static void carryOver(QVector<float> &next, const QVector<float> &current, const int *from, int count, float init)
+{
+    next.resize(count);
+    float *out = next.data();
+    const float *in = current.constData();
+    for (int i = 0; i < count; ++i)
+        out[i] = from[i] >= 0 ? in[from[i]] : init;
+}
+
+void QTuioFilterBank::realign(float *const *values, int channels, const int *ids, const uchar *pressed, int count)
+{
+    // both ID lists are sorted, so matching sessions up is one merge
+    m_from.resize(count);
+    const int previous = m_ids.size();
+    int j = 0;
+    for (int i = 0; i < count; ++i) {
+        while (j < previous && m_ids.at(j) < ids[i])
+            ++j;
+        m_from[i] = j < previous && m_ids.at(j) == ids[i] && !pressed[i] ? j : -1;
+    }
+
+    const int *from = m_from.constData();
+    for (int c = 0; c < channels; ++c) {
+        Channel &channel = m_channels[c];
+        carryOver(m_next.value, channel.value, from, count, values[c]);
+        carryOver(m_next.rate, channel.rate, from, count, 0.0f);
+        carryOver(m_next.p00, channel.p00, from, count, m_parameters.measurementNoise);
+        carryOver(m_next.p01, channel.p01, from, count, 0.0f);
+        carryOver(m_next.p11, channel.p11, from, count, InitialRateVariance);
+        qSwap(channel, m_next);
+    }
+
+    m_nextIds.resize(count);
+    std::copy(ids, ids + count, m_nextIds.begin());
+    m_ids.swap(m_nextIds);
+}
+
+void QTuioFilterBank::filter(float *const *values, int channels, const int *ids, const uchar *pressed,
+                             int count, float dt)
+{
+    realign(values, channels, ids, pressed, count);
+
+    for (int c = 0; c < channels; ++c) {
+        Channel &channel = m_channels[c];
+        const bool angle = c == 2;
+        switch (m_parameters.type) {
+        case QTuioFilterParameters::OneEuroFilter:
+            if (angle)
+                oneEuro<true>(channel.value.data(), channel.rate.data(), values[c], count, dt, m_parameters);
+            else
+                oneEuro<false>(channel.value.data(), channel.rate.data(), values[c], count, dt, m_parameters);
+            break;
+        case QTuioFilterParameters::KalmanFilter:
+            if (angle)
+                kalman<true>(channel.value.data(), channel.rate.data(), channel.p00.data(), channel.p01.data(),
+                             channel.p11.data(), values[c], count, dt, m_parameters);
+            else
+                kalman<false>(channel.value.data(), channel.rate.data(), channel.p00.data(), channel.p01.data(),
+                              channel.p11.data(), values[c], count, dt, m_parameters);
+            break;
+        case QTuioFilterParameters::NoFilter:
+            break;
+        }
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,204 @@
+#ifndef QTUIOSESSIONFILTER_P_H
+#define QTUIOSESSIONFILTER_P_H
+
+#include <QtCore/QVector>
+
+#include <algorithm>
+#include <cmath>
+
+#include "qtuiocursor_p.h"
+#include "qtuiosessionset_p.h"
+
+QT_BEGIN_NAMESPACE
+
+struct QTuioFilterParameters
+{
+    enum Type {
+        NoFilter,
+        // adaptive low-pass: smooths slow motion a lot, fast motion little
+        OneEuroFilter,
+        // constant velocity Kalman filter
+        KalmanFilter
+    };
+
+    QTuioFilterParameters()
+        : type(NoFilter)
+        , minCutoff(1.0f)
+        , beta(10.0f)
+        , derivativeCutoff(1.0f)
+        , processNoise(1.0f)
+        , measurementNoise(1e-6f)
+    {
+    }
+
+    Type type;
+
+    // One Euro: the cutoff frequency in Hz at rest, how fast it rises with
+    // speed (in screen sizes, or turns, per second), and the cutoff used to
+    // smooth the speed itself
+    float minCutoff;
+    float beta;
+    float derivativeCutoff;
+
+    // Kalman: the spectral density of the acceleration, and the variance of
+    // the tracker's measurements, in screen sizes (or turns) squared
+    float processNoise;
+    float measurementNoise;
+};
+
+/*!
+    \internal
+
+    The filter state of all the sessions of one profile, in structure of
+    arrays form: one contiguous float array per state variable and channel,
+    indexed like the sessions, so the update loops vectorize.
+
+    Channels are x and y, and for tokens and blobs the angle, in turns so
+    the same parameters work for it; it wraps around.
+*/
+class QTuioFilterBank
+{
+public:
+    enum { MaxChannels = 3 };
+
+    QTuioFilterBank() {}
+
+    void setParameters(const QTuioFilterParameters &parameters) { m_parameters = parameters; }
+    const QTuioFilterParameters &parameters() const { return m_parameters; }
+
+    // Filters the \a count sessions \a ids, sorted, whose measurements are
+    // in \a values, one array per channel, and overwrites them with the
+    // filtered values. Sessions flagged in \a pressed, or not in the previous
+    // call, start from their measurement; sessions missing since the
+    // previous call are dropped. \a dt is in seconds.
+    void filter(float *const *values, int channels, const int *ids, const uchar *pressed, int count, float dt);
+
+private:
+    struct Channel
+    {
+        QVector<float> value;
+        QVector<float> rate;
+        // Kalman covariance
+        QVector<float> p00;
+        QVector<float> p01;
+        QVector<float> p11;
+    };
+
+    void realign(float *const *values, int channels, const int *ids, const uchar *pressed, int count);
+
+    QTuioFilterParameters m_parameters;
+    QVector<int> m_ids;
+    Channel m_channels[MaxChannels];
+
+    // reused for realigning, then swapped in
+    QVector<int> m_from;
+    QVector<int> m_nextIds;
+    Channel m_next;
+};
+
+// what of a session is filtered besides its position
+template <typename T>
+struct QTuioFilterAngle
+{
+    enum { Channels = 3 };
+    static float get(const T &session) { return session.angle() / float(2 * M_PI); }
+    // any number of turns, brought back into 0..2pi like a received angle,
+    // so setAngle() treats both the same
+    static void set(T &session, float turns)
+    {
+        const float wrapped = turns - std::floor(turns);
+        session.setAngle(wrapped < 1 ? wrapped * float(2 * M_PI) : 0);
+    }
+};
+
+template <>
+struct QTuioFilterAngle<QTuioCursor>
+{
+    enum { Channels = 2 };
+    static float get(const QTuioCursor &) { return 0; }
+    static void set(QTuioCursor &, float) {}
+};
+
+/*!
+    \internal
+
+    Smooths the sessions of one profile of one source, once per committed
+    frame. output() is what goes into frames: the filtered sessions, or a
+    copy of the sessions when filtering is off. It is a copy rather than
+    shared, so neither the session set nor output() ever has to detach.
+
+    A filtered session keeps moving for a little while after the tracker
+    reports it stationary, so those are told moved or stationary again by
+    comparing them to the previous output.
+*/
+template <typename T>
+class QTuioSessionFilter
+{
+public:
+    QTuioSessionFilter() : m_lastTime(0) {}
+
+    void setParameters(const QTuioFilterParameters &parameters) { m_bank.setParameters(parameters); }
+
+    const QVector<T> &output() const { return m_output; }
+
+    // \a time is when the sessions were measured, in ns
+    void apply(const QVector<T> &sessions, qint64 time)
+    {
+        const bool filtering = m_bank.parameters().type != QTuioFilterParameters::NoFilter;
+        if (filtering)
+            m_previous.swap(m_output);
+        m_output.resize(sessions.size());
+        std::copy(sessions.constBegin(), sessions.constEnd(), m_output.begin());
+        if (!filtering)
+            return;
+
+        // the frame interval, within reason: a pause or a tracker without a
+        // clock mustn't throw the filters off
+        const float dt = m_lastTime ? qBound(0.001f, float(time - m_lastTime) / 1e9f, 0.1f) : 1.0f / 60;
+        m_lastTime = time;
+
+        const int count = sessions.size();
+        const int channels = QTuioFilterAngle<T>::Channels;
+        m_ids.resize(count);
+        m_pressed.resize(count);
+        float *values[QTuioFilterBank::MaxChannels];
+        for (int c = 0; c < channels; ++c) {
+            m_values[c].resize(count);
+            values[c] = m_values[c].data();
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const T &session = sessions.at(i);
+            m_ids[i] = session.id();
+            m_pressed[i] = session.state() == Qt::TouchPointPressed;
+            values[0][i] = session.x();
+            values[1][i] = session.y();
+            if (channels > 2)
+                values[2][i] = QTuioFilterAngle<T>::get(session);
+        }
+
+        m_bank.filter(values, channels, m_ids.constData(), m_pressed.constData(), count, dt);
+
+        T *filtered = m_output.data();
+        for (int i = 0; i < count; ++i) {
+            filtered[i].setX(values[0][i]);
+            filtered[i].setY(values[1][i]);
+            if (channels > 2)
+                QTuioFilterAngle<T>::set(filtered[i], values[2][i]);
+        }
+        qt_tuioDetectMotion(m_previous, m_output, Qt::TouchPointStationary);
+    }
+
+private:
+    QTuioFilterBank m_bank;
+    QVector<int> m_ids;
+    QVector<uchar> m_pressed;
+    QVector<float> m_values[QTuioFilterBank::MaxChannels];
+    QVector<T> m_output;
+    QVector<T> m_previous; // the output before, when filtering
+    qint64 m_lastTime;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOSESSIONFILTER_P_H
@@ -0,0 +1,215 @@
+#ifndef QTUIOSESSIONSET_P_H
+#define QTUIOSESSIONSET_P_H
+
+#include <QtCore/QVector>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "qtuiocursor_p.h"
+#include "qtuiotoken_p.h"
+#include "qtuioblob_p.h"
+#include "qtuioslotallocator_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// sessions are copied around in bulk, by value
+Q_STATIC_ASSERT(std::is_trivially_copyable<QTuioCursor>::value);
+Q_STATIC_ASSERT(std::is_trivially_copyable<QTuioToken>::value);
+Q_STATIC_ASSERT(std::is_trivially_copyable<QTuioBlob>::value);
+
+// cursors have no angle
+inline float qt_tuioSessionAngle(const QTuioCursor &) { return 0; }
+template <typename T>
+inline float qt_tuioSessionAngle(const T &session) { return session.angle(); }
+
+// Whether \a after, a session of a later frame than \a before, moved from
+// it. The comparison is exact, so it agrees with any consumer comparing
+// the positions it is given.
+template <typename T>
+inline bool qt_tuioSessionMoved(const T &before, const T &after)
+{
+    return before.x() != after.x() || before.y() != after.y()
+            || qt_tuioSessionAngle(before) != qt_tuioSessionAngle(after);
+}
+
+// Sets the sessions of \a sessions whose state is \a unresolved to moved or
+// stationary, by how they compare to the same sessions in \a before. Both
+// are sorted by ID, so pairing them up is one merge; sessions \a before
+// lacks are left alone.
+template <typename T>
+void qt_tuioDetectMotion(const QVector<T> &before, QVector<T> &sessions, Qt::TouchPointState unresolved)
+{
+    const T *old = before.constData();
+    const int oldCount = before.size();
+    T *session = sessions.data();
+    int j = 0;
+    for (int i = 0; i < sessions.size(); ++i) {
+        if (session[i].state() != unresolved)
+            continue;
+        while (j < oldCount && old[j].id() < session[i].id())
+            ++j;
+        if (j < oldCount && old[j].id() == session[i].id())
+            session[i].setState(qt_tuioSessionMoved(old[j], session[i]) ? Qt::TouchPointMoved : Qt::TouchPointStationary);
+    }
+}
+
+/*!
+    \internal
+
+    The active sessions of one TUIO profile, kept in a contiguous vector
+    sorted by session ID. Lookups are a binary search, and ALIVE messages
+    are diffed against the set by merging the two sorted ID lists: no
+    per-entry nodes, and no allocations in steady state.
+
+    ALIVE and SET messages don't touch the committed sessions, they build a
+    staged frame on the side. Only commit() makes it current, so a frame
+    whose FSEQ turns out to be stale, or never arrives, is simply dropped.
+
+    T is QTuioCursor, QTuioToken or QTuioBlob.
+*/
+template <typename T>
+class QTuioSessionSet
+{
+public:
+    typedef typename QVector<T>::const_iterator const_iterator;
+
+    QTuioSessionSet() : m_staged(false) {}
+
+    // the committed sessions
+    int size() const { return m_sessions.size(); }
+    bool isEmpty() const { return m_sessions.isEmpty(); }
+
+    const_iterator begin() const { return m_sessions.constBegin(); }
+    const_iterator end() const { return m_sessions.constEnd(); }
+
+    // sorted by session ID
+    const QVector<T> &values() const { return m_sessions; }
+
+    bool isStaged() const { return m_staged; }
+    // committed sessions the staged frame will release
+    int releasedCount() const { return m_released.size(); }
+
+    // looks \a id up in the staged frame, which a SET then updates
+    T *find(int id)
+    {
+        stage();
+        T *first = m_pending.data();
+        T *last = first + m_pending.size();
+        T *it = std::lower_bound(first, last, id, [](const T &session, int id) { return session.id() < id; });
+        return it != last && it->id() == id ? it : nullptr;
+    }
+
+    /*!
+        Stages the \a count session IDs at \a ids as the next alive set,
+        replacing whatever was staged before. Known sessions are carried
+        over (commit() tells whether a following SET moved them), new ones
+        are added as pressed, and committed sessions missing from \a ids
+        will be released on commit().
+
+        Both lists are sorted, so this is a single merge over them. \a ids is
+        sorted in place first if needed; trackers usually send them in order.
+    */
+    void setAlive(int *ids, int count)
+    {
+        if (!std::is_sorted(ids, ids + count))
+            std::sort(ids, ids + count);
+
+        const T *old = m_sessions.constData();
+        const int oldCount = m_sessions.size();
+        m_pending.resize(0);
+        m_pending.reserve(qMax(oldCount, count));
+        m_released.resize(0);
+
+        int i = 0;
+        int j = 0;
+        while (i < oldCount || j < count) {
+            if (j == count || (i < oldCount && old[i].id() < ids[j])) {
+                m_released.append(old[i++]);
+                continue;
+            }
+
+            if (i == oldCount || ids[j] < old[i].id()) {
+                T added(ids[j]);
+                added.setState(Qt::TouchPointPressed);
+                m_pending.append(added);
+            } else {
+                m_pending.append(old[i++]);
+                m_pending.last().setState(carried());
+            }
+
+            // a sender listing an ID twice must not create it twice
+            for (++j; j < count && ids[j] == ids[j - 1]; ++j) {}
+        }
+
+        m_staged = true;
+    }
+
+    /*!
+        Makes the staged frame the committed one, and appends the sessions it
+        released to \a released. A frame with no ALIVE commits the current
+        sessions, as stationary.
+
+        Whether carried over sessions moved or not is decided here, for all
+        of them at once, in one pass comparing them to the committed ones
+        rather than field by field as SETs come in.
+
+        New sessions get a slot from \a allocator, and released sessions give
+        theirs back, after the new ones got theirs: a slot is never reused
+        within the frame that released it.
+
+        The storage of the previous set is reused for the next staged frame,
+        so once it has grown to the number of live sessions nothing is
+        allocated.
+    */
+    void commit(QVector<T> &released, QTuioSlotAllocator &allocator)
+    {
+        stage();
+        detectMotion();
+        T *pending = m_pending.data();
+        for (int i = 0; i < m_pending.size(); ++i) {
+            if (pending[i].slot() < 0)
+                pending[i].setSlot(allocator.allocate());
+        }
+        for (const T &session : m_released) {
+            allocator.release(session.slot());
+            released.append(session);
+        }
+        m_sessions.swap(m_pending);
+        m_staged = false;
+    }
+
+    void discard() { m_staged = false; }
+
+private:
+    // a SET or FSEQ with no ALIVE before it applies to the committed sessions
+    void stage()
+    {
+        if (m_staged)
+            return;
+        m_pending.resize(0);
+        for (const T &session : m_sessions) {
+            m_pending.append(session);
+            m_pending.last().setState(carried());
+        }
+        m_released.resize(0);
+        m_staged = true;
+    }
+
+    // Sets carried over sessions to moved or stationary; they are all in
+    // the committed set.
+    void detectMotion() { qt_tuioDetectMotion(m_sessions, m_pending, carried()); }
+
+    // the state of a staged session carried over from the committed set,
+    // until commit() knows if it moved; SETs leave it alone
+    static Qt::TouchPointState carried() { return Qt::TouchPointMoved; }
+
+    QVector<T> m_sessions;
+    QVector<T> m_pending; // the staged frame
+    QVector<T> m_released; // committed sessions the staged frame drops
+    bool m_staged;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOSESSIONSET_P_H
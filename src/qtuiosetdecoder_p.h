@@ -0,0 +1,137 @@
+#ifndef QTUIOSETDECODER_P_H
+#define QTUIOSETDECODER_P_H
+
+#include <string.h>
+
+#include "qoscmessageview_p.h"
+#include "qoscsimd_p.h"
+#include "qtuiocursor_p.h"
+#include "qtuiotoken_p.h"
+#include "qtuioblob_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Fixed layout of a TUIO 1.1 profile SET message, specialized per entity
+    type. \c signature() is the complete type tag string (without the leading
+    ','), \c apply() copies the fields following the session ID into the
+    entity. All arguments after the "set" string are 32 bit words, so every
+    field lives at a fixed word index; word 0 is the session ID.
+*/
+template <typename T>
+struct QTuioSetSchema;
+
+Q_DECL_CONSTEXPR inline int qt_tuioSignatureLength(const char *signature)
+{
+    return *signature ? 1 + qt_tuioSignatureLength(signature + 1) : 0;
+}
+
+// /tuio/2Dcur set s x y X Y m
+template <>
+struct QTuioSetSchema<QTuioCursor>
+{
+    static Q_DECL_CONSTEXPR const char *signature() { return "sifffff"; }
+    enum { SignatureLength = 7, WordCount = 6 };
+
+    static void apply(const quint32 *words, QTuioCursor &cursor)
+    {
+        cursor.setX(qt_oscWordToFloat(words[1]));
+        cursor.setY(qt_oscWordToFloat(words[2]));
+        cursor.setVX(qt_oscWordToFloat(words[3]));
+        cursor.setVY(qt_oscWordToFloat(words[4]));
+        cursor.setAcceleration(qt_oscWordToFloat(words[5]));
+    }
+};
+Q_STATIC_ASSERT(qt_tuioSignatureLength(QTuioSetSchema<QTuioCursor>::signature()) == QTuioSetSchema<QTuioCursor>::SignatureLength);
+
+// /tuio/2Dobj set s i x y a X Y A m r
+template <>
+struct QTuioSetSchema<QTuioToken>
+{
+    static Q_DECL_CONSTEXPR const char *signature() { return "siiffffffff"; }
+    enum { SignatureLength = 11, WordCount = 10 };
+
+    static void apply(const quint32 *words, QTuioToken &token)
+    {
+        token.setClassId(qint32(words[1]));
+        token.setX(qt_oscWordToFloat(words[2]));
+        token.setY(qt_oscWordToFloat(words[3]));
+        token.setAngle(qt_oscWordToFloat(words[4]));
+        token.setVX(qt_oscWordToFloat(words[5]));
+        token.setVY(qt_oscWordToFloat(words[6]));
+        token.setAngularVelocity(qt_oscWordToFloat(words[7]));
+        token.setAcceleration(qt_oscWordToFloat(words[8]));
+        token.setAngularAcceleration(qt_oscWordToFloat(words[9]));
+    }
+};
+Q_STATIC_ASSERT(qt_tuioSignatureLength(QTuioSetSchema<QTuioToken>::signature()) == QTuioSetSchema<QTuioToken>::SignatureLength);
+
+// /tuio/2Dblb set s x y a w h f X Y A m r
+template <>
+struct QTuioSetSchema<QTuioBlob>
+{
+    static Q_DECL_CONSTEXPR const char *signature() { return "sifffffffffff"; }
+    enum { SignatureLength = 13, WordCount = 12 };
+
+    static void apply(const quint32 *words, QTuioBlob &blob)
+    {
+        blob.setX(qt_oscWordToFloat(words[1]));
+        blob.setY(qt_oscWordToFloat(words[2]));
+        blob.setAngle(qt_oscWordToFloat(words[3]));
+        blob.setWidth(qt_oscWordToFloat(words[4]));
+        blob.setHeight(qt_oscWordToFloat(words[5]));
+        blob.setArea(qt_oscWordToFloat(words[6]));
+        blob.setVX(qt_oscWordToFloat(words[7]));
+        blob.setVY(qt_oscWordToFloat(words[8]));
+        blob.setVR(qt_oscWordToFloat(words[9]));
+        blob.setAcceleration(qt_oscWordToFloat(words[10]));
+        blob.setRotationAcceleration(qt_oscWordToFloat(words[11]));
+    }
+};
+Q_STATIC_ASSERT(qt_tuioSignatureLength(QTuioSetSchema<QTuioBlob>::signature()) == QTuioSetSchema<QTuioBlob>::SignatureLength);
+
+/*!
+    \internal
+
+    Decodes a profile SET message in place. The whole type tag string is
+    matched with a single memcmp against the schema, so a valid decoder
+    guarantees every field the schema reads is present and of the right type.
+*/
+template <typename T>
+class QTuioSetDecoder
+{
+    typedef QTuioSetSchema<T> Schema;
+    Q_STATIC_ASSERT(int(Schema::WordCount) == int(Schema::SignatureLength) - 1);
+
+public:
+    explicit QTuioSetDecoder(const QOscMessageView &message)
+        : m_isValid(false)
+    {
+        const QLatin1String typeTags = message.typeTags();
+        if (typeTags.size() != Schema::SignatureLength
+                || memcmp(typeTags.data(), Schema::signature(), Schema::SignatureLength) != 0)
+            return;
+
+        if (message.stringAt(0) != QLatin1String("set"))
+            return;
+
+        // the numeric arguments form one run of words, swap them in one go
+        message.wordsAt(1, Schema::WordCount, m_words);
+        m_isValid = true;
+    }
+
+    bool isValid() const { return m_isValid; }
+
+    int id() const { return qint32(m_words[0]); }
+    void apply(T &entity) const { Schema::apply(m_words, entity); }
+
+private:
+    bool m_isValid;
+    quint32 m_words[Schema::WordCount];
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOSETDECODER_P_H
@@ -0,0 +1,52 @@
+#ifndef QTUIOSLOTALLOCATOR_P_H
+#define QTUIOSLOTALLOCATOR_P_H
+
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Hands out slots: small indexes standing in for session IDs, which grow
+    without bound over a tracker's lifetime. A new session gets the lowest
+    slot not in use, and a released session's slot is reused, so slots stay
+    dense and state can live in plain arrays indexed by them.
+
+    Slots in use are kept as a bitmap, which only grows with the most
+    sessions ever alive at once.
+*/
+class QTuioSlotAllocator
+{
+public:
+    QTuioSlotAllocator() {}
+
+    int allocate()
+    {
+        for (int word = 0; word < m_used.size(); ++word) {
+            const quint64 free = ~m_used.at(word);
+            if (free) {
+                const int bit = int(qCountTrailingZeroBits(free));
+                m_used[word] |= Q_UINT64_C(1) << bit;
+                return word * 64 + bit;
+            }
+        }
+
+        m_used.append(1);
+        return (m_used.size() - 1) * 64;
+    }
+
+    void release(int slot)
+    {
+        if (slot >= 0 && slot / 64 < m_used.size())
+            m_used[slot / 64] &= ~(Q_UINT64_C(1) << (slot % 64));
+    }
+
+private:
+    QVector<quint64> m_used;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOSLOTALLOCATOR_P_H
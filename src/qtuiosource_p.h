@@ -0,0 +1,105 @@
+#ifndef QTUIOSOURCE_P_H
+#define QTUIOSOURCE_P_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLatin1String>
+#include <QtCore/QVector>
+#include <QtNetwork/QHostAddress>
+
+#include "qtuiocursor_p.h"
+#include "qtuiotoken_p.h"
+#include "qtuioblob_p.h"
+#include "qtuioclocksync_p.h"
+#include "qtuiosessionfilter_p.h"
+#include "qtuiodispatch_p.h"
+#include "qtuiosessionset_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Everything the handler tracks for one TUIO source: a tracker, told apart
+    by the endpoint it sends from and the name in its SOURCE messages, if it
+    sends any. Session IDs are only unique within a source, so each one gets
+    its own active and dead sets.
+*/
+struct QTuioSource
+{
+    QTuioSource(int id, const QHostAddress &sender, quint16 senderPort, QLatin1String name)
+        : id(id)
+        , sender(sender)
+        , senderPort(senderPort)
+        , name(name.data(), name.size())
+        , lastHeard(0)
+    {
+        for (int profile = 0; profile < QTuioProfileCount; ++profile) {
+            fseq[profile] = -1;
+            pendingAlive[profile] = 0;
+            stagedSince[profile] = 0;
+        }
+    }
+
+    bool matches(const QHostAddress &otherSender, quint16 otherPort, QLatin1String otherName) const
+    {
+        return senderPort == otherPort && QLatin1String(name) == otherName && sender == otherSender;
+    }
+
+    int id;
+    QHostAddress sender;
+    quint16 senderPort;
+    QByteArray name; // "name@address" from the SOURCE message, may be empty
+    qint64 lastHeard; // arrival time of its latest message
+
+    qint32 fseq[QTuioProfileCount]; // last FSEQ committed per profile, -1 for none
+    // ALIVEs staged since the last commit, and when the first one arrived
+    int pendingAlive[QTuioProfileCount];
+    qint64 stagedSince[QTuioProfileCount];
+
+    // the tracker's clock, from the time tags of its bundles
+    QTuioClockSync clock;
+
+    QTuioSessionSet<QTuioCursor> cursors;
+    QVector<QTuioCursor> deadCursors;
+    QTuioSessionSet<QTuioToken> tokens;
+    QVector<QTuioToken> deadTokens;
+    QTuioSessionSet<QTuioBlob> blobs;
+    QVector<QTuioBlob> deadBlobs;
+
+    // what goes into frames, filtered or not
+    QTuioSessionFilter<QTuioCursor> cursorFilter;
+    QTuioSessionFilter<QTuioToken> tokenFilter;
+    QTuioSessionFilter<QTuioBlob> blobFilter;
+};
+
+/*!
+    \internal
+
+    Session IDs made unique across sources, for the merged view: the source
+    ID goes in the top 8 bits and the low 24 bits of the session ID below.
+    Trackers number sessions from 0 upwards, so in practice sessions keep
+    their order.
+*/
+Q_DECL_CONSTEXPR inline int qt_tuioGlobalId(int sourceId, int sessionId)
+{
+    return int(quint32(sourceId) << 24 | (quint32(sessionId) & 0xffffff));
+}
+
+/*!
+    \internal
+
+    Whether frame \a fseq comes after frame \a last, allowing for the frame
+    ID wrapping around. A frame far behind the last one means the tracker
+    restarted and counts from the beginning again, rather than that the
+    network held it back for that long.
+*/
+inline bool qt_tuioFseqIsNewer(qint32 fseq, qint32 last)
+{
+    enum { RestartDistance = 1024 };
+    const qint32 distance = qint32(quint32(fseq) - quint32(last));
+    return distance > 0 || distance < -RestartDistance;
+}
+
+QT_END_NAMESPACE
+
+#endif // QTUIOSOURCE_P_H
@@ -0,0 +1,74 @@
+#ifndef QTUIOSPSCRING_P_H
+#define QTUIOSPSCRING_P_H
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    A bounded, lock-free ring for exactly one producer thread and one
+    consumer thread. push() is only ever called by the producer and pop() by
+    the consumer; each side writes one index and reads the other's.
+
+    The capacity is rounded up to a power of two. Slots are allocated once,
+    and a popped slot keeps its old value until it is written again, so
+    neither side allocates or frees anything.
+*/
+template <typename T>
+class QTuioSpscRing
+{
+public:
+    explicit QTuioSpscRing(int capacity)
+        : m_mask(1)
+        , m_head(0)
+        , m_tail(0)
+    {
+        while (int(m_mask) < capacity)
+            m_mask <<= 1;
+        m_slots.resize(int(m_mask));
+        m_data = m_slots.data();
+        --m_mask;
+    }
+
+    int capacity() const { return int(m_mask) + 1; }
+
+    // producer only; returns false, dropping \a value, if the ring is full
+    bool push(const T &value)
+    {
+        const quint32 tail = m_tail.load();
+        if (tail - m_head.loadAcquire() > m_mask)
+            return false;
+        m_data[tail & m_mask] = value;
+        m_tail.storeRelease(tail + 1);
+        return true;
+    }
+
+    // consumer only; returns false if the ring is empty
+    bool pop(T &value)
+    {
+        const quint32 head = m_head.load();
+        if (head == m_tail.loadAcquire())
+            return false;
+        qSwap(value, m_data[head & m_mask]);
+        m_head.storeRelease(head + 1);
+        return true;
+    }
+
+private:
+    Q_DISABLE_COPY(QTuioSpscRing)
+
+    QVector<T> m_slots;
+    T *m_data;
+    quint32 m_mask;
+    // each index is written by one side only, keep them on separate cache
+    // lines so the two threads don't keep stealing each other's
+    alignas(64) QAtomicInteger<quint32> m_head; // next slot to pop
+    alignas(64) QAtomicInteger<quint32> m_tail; // next slot to push
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOSPSCRING_P_H
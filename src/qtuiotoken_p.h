@@ -57,6 +57,7 @@ class QTuioToken
 public:
     QTuioToken(int id = -1)
         : m_id(id)
+        , m_slot(-1)
         , m_classId(-1)
         , m_x(0)
         , m_y(0)
@@ -71,28 +72,19 @@ public:
     }
 
     int id() const { return m_id; }
+    void setId(int id) { m_id = id; }
+
+    // a small index, unique among the live tokens and reused once released
+    int slot() const { return m_slot; }
+    void setSlot(int slot) { m_slot = slot; }
 
     int classId() const { return m_classId; }
     void setClassId(int classId) { m_classId = classId; }
 
-    void setX(float x)
-    {
-        if (state() == Qt::TouchPointStationary &&
-            !qFuzzyCompare(m_x + 2.0, x + 2.0)) { // +2 because 1 is a valid value, and qFuzzyCompare can't cope with 0.0
-            setState(Qt::TouchPointMoved);
-        }
-        m_x = x;
-    }
+    void setX(float x) { m_x = x; }
     float x() const { return m_x; }
 
-    void setY(float y)
-    {
-        if (state() == Qt::TouchPointStationary &&
-            !qFuzzyCompare(m_y + 2.0, y + 2.0)) { // +2 because 1 is a valid value, and qFuzzyCompare can't cope with 0.0
-            setState(Qt::TouchPointMoved);
-        }
-        m_y = y;
-    }
+    void setY(float y) { m_y = y; }
     float y() const { return m_y; }
 
     void setVX(float vx) { m_vx = vx; }
@@ -109,10 +101,6 @@ public:
     {
         if (angle > M_PI)
             angle = angle - M_PI * 2.0; // zero is pointing upwards, and is the default; but we want to have negative angles when rotating left
-        if (state() == Qt::TouchPointStationary &&
-            !qFuzzyCompare(m_angle + 2.0, angle + 2.0)) { // +2 because 1 is a valid value, and qFuzzyCompare can't cope with 0.0
-            setState(Qt::TouchPointMoved);
-        }
         m_angle = angle;
     }
 
@@ -127,6 +115,7 @@ public:
 
 private:
     int m_id;       // sessionID, temporary object ID
+    int m_slot;     // dense index, see QTuioSlotAllocator
     int m_classId;  // classID (e.g. marker ID)
     float m_x;
     float m_y;
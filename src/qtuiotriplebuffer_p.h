@@ -0,0 +1,62 @@
+#ifndef QTUIOTRIPLEBUFFER_P_H
+#define QTUIOTRIPLEBUFFER_P_H
+
+#include <QtCore/QAtomicInteger>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+
+    Hands the latest of a stream of values from one writer thread to one
+    reader thread, wait-free on both sides. The writer fills a back slot and
+    swaps it with the middle one; the reader swaps the middle slot with its
+    front one if the writer left something newer there. Neither side ever
+    waits for the other, and values the reader didn't get to are simply
+    overwritten.
+
+    Each slot belongs to one side at a time, so T needs no synchronization
+    of its own beyond the swaps.
+*/
+template <typename T>
+class QTuioTripleBuffer
+{
+public:
+    QTuioTripleBuffer()
+        : m_slots()
+        , m_back(0)
+        , m_middle(1)
+        , m_front(2)
+    {
+    }
+
+    // writer only
+    void write(const T &value)
+    {
+        m_slots[m_back] = value;
+        m_back = m_middle.fetchAndStoreOrdered(quint32(m_back) | Fresh) & Index;
+    }
+
+    // reader only; the latest value written, or the one read last if
+    // nothing was written since
+    const T &read()
+    {
+        if (m_middle.loadAcquire() & Fresh)
+            m_front = m_middle.fetchAndStoreOrdered(quint32(m_front)) & Index;
+        return m_slots[m_front];
+    }
+
+private:
+    Q_DISABLE_COPY(QTuioTripleBuffer)
+
+    enum { Index = 3, Fresh = 4 };
+
+    T m_slots[3];
+    int m_back; // the writer's
+    QAtomicInteger<quint32> m_middle; // slot index, and Fresh if unread
+    int m_front; // the reader's
+};
+
+QT_END_NAMESPACE
+
+#endif // QTUIOTRIPLEBUFFER_P_H
@@ -0,0 +1,182 @@
+#include "qudpbatchreceiver_p.h"
+
+#ifdef Q_OS_LINUX
+
+#include <QtCore/QDebug>
+#include <QtCore/QSocketNotifier>
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+static const int ControlSize = CMSG_SPACE(sizeof(timespec));
+
+QUdpBatchReceiver::QUdpBatchReceiver(const DatagramHandler &handler)
+    : m_handler(handler)
+    , m_fd(-1)
+    , m_notifier(nullptr)
+    , m_lastSenderLength(0)
+    , m_senderPort(0)
+{
+    memset(&m_lastSender, 0, sizeof(m_lastSender));
+}
+
+QUdpBatchReceiver::~QUdpBatchReceiver()
+{
+    delete m_notifier;
+    if (m_fd >= 0)
+        ::close(m_fd);
+}
+
+bool QUdpBatchReceiver::bind(const QHostAddress &address, quint16 port, int receiveBufferSize, int batchSize)
+{
+    sockaddr_storage local;
+    socklen_t localLength;
+    memset(&local, 0, sizeof(local));
+    if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+        sockaddr_in6 *in6 = reinterpret_cast<sockaddr_in6 *>(&local);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        const Q_IPV6ADDR ip6 = address.toIPv6Address();
+        memcpy(&in6->sin6_addr, &ip6, sizeof(ip6));
+        localLength = sizeof(sockaddr_in6);
+    } else {
+        sockaddr_in *in = reinterpret_cast<sockaddr_in *>(&local);
+        in->sin_family = AF_INET;
+        in->sin_port = htons(port);
+        in->sin_addr.s_addr = htonl(address.toIPv4Address());
+        localLength = sizeof(sockaddr_in);
+    }
+
+    m_fd = ::socket(local.ss_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_fd < 0) {
+        qWarning("QUdpBatchReceiver: cannot create socket: %s", strerror(errno));
+        return false;
+    }
+
+    // a burst from several trackers must fit in the socket buffer until the
+    // next drain. The kernel caps the size at net.core.rmem_max, and reports
+    // back double what it grants.
+    if (receiveBufferSize > 0) {
+        ::setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+        int granted = 0;
+        socklen_t grantedLength = sizeof(granted);
+        ::getsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &granted, &grantedLength);
+        if (granted / 2 < receiveBufferSize)
+            qWarning("QUdpBatchReceiver: asked for a %d byte receive buffer, got %d (see net.core.rmem_max)",
+                     receiveBufferSize, granted / 2);
+    }
+
+    const int on = 1;
+    if (::setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) < 0)
+        qWarning("QUdpBatchReceiver: no kernel timestamps, using the time datagrams are read instead");
+
+    if (::bind(m_fd, reinterpret_cast<sockaddr *>(&local), localLength) < 0) {
+        qWarning("QUdpBatchReceiver: cannot bind to %s:%u: %s",
+                 qPrintable(address.toString()), unsigned(port), strerror(errno));
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    batchSize = qMax(1, batchSize);
+    m_buffers.resize(batchSize * MaxDatagramSize);
+    m_controls.resize(batchSize * ControlSize);
+    m_headers.resize(batchSize);
+    m_iovecs.resize(batchSize);
+    m_addresses.resize(batchSize);
+    for (int i = 0; i < batchSize; ++i) {
+        m_iovecs[i].iov_base = m_buffers.data() + i * MaxDatagramSize;
+        m_iovecs[i].iov_len = MaxDatagramSize;
+        resetHeader(i);
+    }
+
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read);
+    QObject::connect(m_notifier, &QSocketNotifier::activated, [this]() { readDatagrams(); });
+    return true;
+}
+
+void QUdpBatchReceiver::resetHeader(int i)
+{
+    msghdr &header = m_headers[i].msg_hdr;
+    header.msg_name = &m_addresses[i];
+    header.msg_namelen = sizeof(sockaddr_storage);
+    header.msg_iov = &m_iovecs[i];
+    header.msg_iovlen = 1;
+    header.msg_control = m_controls.data() + i * ControlSize;
+    header.msg_controllen = ControlSize;
+    header.msg_flags = 0;
+}
+
+void QUdpBatchReceiver::updateSender(const sockaddr_storage &address, socklen_t length)
+{
+    if (length == m_lastSenderLength && memcmp(&address, &m_lastSender, length) == 0)
+        return;
+
+    memcpy(&m_lastSender, &address, length);
+    m_lastSenderLength = length;
+    m_senderAddress.setAddress(reinterpret_cast<const sockaddr *>(&address));
+    if (address.ss_family == AF_INET6)
+        m_senderPort = ntohs(reinterpret_cast<const sockaddr_in6 &>(address).sin6_port);
+    else
+        m_senderPort = ntohs(reinterpret_cast<const sockaddr_in &>(address).sin_port);
+}
+
+void QUdpBatchReceiver::readDatagrams()
+{
+    const int batchSize = m_headers.size();
+    for (;;) {
+        const int count = ::recvmmsg(m_fd, m_headers.data(), batchSize, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                qWarning("QUdpBatchReceiver: recvmmsg failed: %s", strerror(errno));
+            return;
+        }
+
+        timespec now;
+        bool haveNow = false;
+        for (int i = 0; i < count; ++i) {
+            msghdr &header = m_headers[i].msg_hdr;
+
+            qint64 arrivalNs = 0;
+            for (cmsghdr *cmsg = CMSG_FIRSTHDR(&header); cmsg; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    timespec stamp;
+                    memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+                    arrivalNs = qint64(stamp.tv_sec) * 1000000000 + stamp.tv_nsec;
+                }
+            }
+            if (!arrivalNs) {
+                if (!haveNow) {
+                    clock_gettime(CLOCK_REALTIME, &now);
+                    haveNow = true;
+                }
+                arrivalNs = qint64(now.tv_sec) * 1000000000 + now.tv_nsec;
+            }
+
+            if (header.msg_flags & MSG_TRUNC) {
+                qWarning("QUdpBatchReceiver: dropping datagram larger than %d bytes", int(MaxDatagramSize));
+            } else {
+                updateSender(m_addresses.at(i), header.msg_namelen);
+                m_handler(static_cast<const char *>(m_iovecs.at(i).iov_base), int(m_headers.at(i).msg_len),
+                          m_senderAddress, m_senderPort, arrivalNs);
+            }
+
+            resetHeader(i);
+        }
+
+        // a short batch means the socket is drained
+        if (count < batchSize)
+            return;
+    }
+}
+
+QT_END_NAMESPACE
+
+#endif // Q_OS_LINUX
@@ -0,0 +1,76 @@
+#ifndef QUDPBATCHRECEIVER_P_H
+#define QUDPBATCHRECEIVER_P_H
+
+#include <QtCore/QVector>
+#include <QtNetwork/QHostAddress>
+
+#include <functional>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+class QSocketNotifier;
+
+#ifdef Q_OS_LINUX
+
+/*!
+    \internal
+
+    Receives UDP datagrams in batches with recvmmsg(), straight into buffers
+    allocated once up front.
+
+    Each time the socket becomes readable it is drained completely, up to
+    batchSize datagrams per syscall, and the handler is called for every
+    datagram with the time the kernel received it (SO_TIMESTAMPNS). The
+    buffers are reused for the next batch, so the handler must not keep the
+    data pointer.
+*/
+class QUdpBatchReceiver
+{
+public:
+    // \a arrivalNs is in nanoseconds since the epoch
+    typedef std::function<void(const char *data, int size, const QHostAddress &sender,
+                               quint16 senderPort, qint64 arrivalNs)> DatagramHandler;
+
+    enum { MaxDatagramSize = 65536 };
+
+    explicit QUdpBatchReceiver(const DatagramHandler &handler);
+    ~QUdpBatchReceiver();
+
+    // \a receiveBufferSize is the SO_RCVBUF to ask for, 0 keeps the default
+    bool bind(const QHostAddress &address, quint16 port, int receiveBufferSize, int batchSize);
+
+private:
+    Q_DISABLE_COPY(QUdpBatchReceiver)
+
+    void readDatagrams();
+    void resetHeader(int i);
+    void updateSender(const sockaddr_storage &address, socklen_t length);
+
+    DatagramHandler m_handler;
+    int m_fd;
+    QSocketNotifier *m_notifier;
+
+    QVector<char> m_buffers; // MaxDatagramSize per datagram
+    QVector<char> m_controls; // room for one timestamp per datagram
+    QVector<mmsghdr> m_headers;
+    QVector<iovec> m_iovecs;
+    QVector<sockaddr_storage> m_addresses;
+
+    // converting the sender is only done when it changes, which with a
+    // single tracker is never
+    sockaddr_storage m_lastSender;
+    socklen_t m_lastSenderLength;
+    QHostAddress m_senderAddress;
+    quint16 m_senderPort;
+};
+
+#endif // Q_OS_LINUX
+
+QT_END_NAMESPACE
+
+#endif // QUDPBATCHRECEIVER_P_H
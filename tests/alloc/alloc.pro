@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# Checks that QTuioHandler, with recycleFrames, processes datagrams without
+# allocating, through malloc() or operator new, once it has warmed up.
+# Needs glibc. Run it with "make check".
+#
+#-------------------------------------------------
+
+QT       += core network
+
+TARGET = tst_alloc
+TEMPLATE = app
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../../sockets/src/companion-qt-sockets.pri)
+include(../../src/companion-qtuio.pri)
+include(../shared/shared.pri)
+
+SOURCES += \
+    main.cpp
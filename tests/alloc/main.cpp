@@ -0,0 +1,213 @@
+#include <QCoreApplication>
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "qtuiohandler.h"
+#include "tuiobundlebuilder.h"
+
+// Replays a reacTIVision style session, one bundle per profile and frame,
+// through QTuioHandler::processDatagram(), to receivers of its signals, and
+// counts the allocations made while doing so. After a warm-up, a handler
+// recycling its frames must not allocate at all.
+//
+// Qt containers allocate with malloc() rather than operator new, so both
+// are counted. The C library's allocator is reached through its glibc
+// names.
+
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *p, std::size_t size);
+void __libc_free(void *p);
+}
+
+static bool counting = false;
+static long allocations = 0;
+
+extern "C" void *malloc(std::size_t size)
+{
+    if (counting)
+        ++allocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(std::size_t count, std::size_t size)
+{
+    if (counting)
+        ++allocations;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *p, std::size_t size)
+{
+    if (counting)
+        ++allocations;
+    return __libc_realloc(p, size);
+}
+
+extern "C" void free(void *p)
+{
+    __libc_free(p);
+}
+
+void *operator new(std::size_t size)
+{
+    if (void *p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    free(p);
+}
+
+namespace {
+
+enum {
+    WarmUpFrames = 200,
+    CountedFrames = 1000
+};
+
+// Frame \a frame of the session: two tokens turning, five fingers moving,
+// one of which is lifted and another one put down every ten frames.
+void appendFrame(QVector<QByteArray> &datagrams, int frame)
+{
+    BundleBuilder tokens("/tuio/2Dobj");
+    tokens.source("alloc@127.0.0.1");
+    const int tokenIds[] = { 1, 2 };
+    tokens.alive(tokenIds, 2);
+    tokens.setToken(1, 4, 0.25f, 0.5f, float(frame % 628) / 100);
+    tokens.setToken(2, 7, 0.75f, 0.5f + 0.0005f * (frame % 100), 0);
+    tokens.fseq(frame + 1);
+    datagrams.append(tokens.bundle());
+
+    BundleBuilder cursors("/tuio/2Dcur");
+    cursors.source("alloc@127.0.0.1");
+    const int base = 10 + frame / 10;
+    const int cursorIds[] = { base, base + 1, base + 2, base + 3, base + 4 };
+    cursors.alive(cursorIds, 5);
+    for (int i = 0; i < 5; ++i)
+        cursors.setCursor(cursorIds[i], 0.1f + 0.15f * i + 0.001f * (frame % 10), 0.3f + 0.0005f * (frame % 100));
+    cursors.fseq(frame + 1);
+    datagrams.append(cursors.bundle());
+}
+
+long countAllocations(const QTuioHandler::Options &options)
+{
+    QVector<QByteArray> datagrams;
+    for (int frame = 0; frame < WarmUpFrames + CountedFrames; ++frame)
+        appendFrame(datagrams, frame);
+
+    QTuioHandler handler(QHostAddress::LocalHost, 0, options);
+
+    // receivers holding on to the latest frame, and reading every session
+    QTuioFrame latest;
+    float sum = 0;
+    QObject::connect(&handler, &QTuioHandler::frameReady, [&latest](const QTuioFrame &frame) {
+        latest = frame;
+    });
+    QObject::connect(&handler, &QTuioHandler::cursorEvent,
+                     [&sum](const QVector<QTuioCursor> &active, const QVector<QTuioCursor> &dead) {
+        for (const QTuioCursor &cursor : active)
+            sum += cursor.x();
+        sum += dead.size();
+    });
+    QObject::connect(&handler, &QTuioHandler::tokenEvent,
+                     [&sum](const QVector<QTuioToken> &active, const QVector<QTuioToken> &dead) {
+        for (const QTuioToken &token : active)
+            sum += token.angle();
+        sum += dead.size();
+    });
+    QObject::connect(&handler, &QTuioHandler::cursorsAdded, [&sum](const QVector<QTuioCursor> &cursors) {
+        sum += cursors.size();
+    });
+    QObject::connect(&handler, &QTuioHandler::cursorsRemoved, [&sum](const QVector<QTuioCursor> &cursors) {
+        sum += cursors.size();
+    });
+    const QHostAddress sender(QHostAddress::LocalHost);
+    const qint64 start = Q_INT64_C(1500000000000000000);
+    const qint64 interval = 16666667;
+
+    long counted = 0;
+    for (int frame = 0; frame < WarmUpFrames + CountedFrames; ++frame) {
+        const qint64 arrival = start + frame * interval;
+        counting = frame >= WarmUpFrames;
+        allocations = 0;
+
+        for (int profile = 0; profile < 2; ++profile) {
+            const QByteArray &datagram = datagrams.at(2 * frame + profile);
+            handler.processDatagram(datagram.constData(), datagram.size(), sender, 3333,
+                                    arrival + profile * 100000);
+        }
+        // what a renderer running behind by one frame would ask for
+        handler.interpolatedFrame(arrival - interval / 2);
+
+        counting = false;
+        counted += allocations;
+    }
+
+    if (latest.cursors().size() != 5 || latest.tokens().size() != 2 || sum == 0) {
+        std::printf("the receivers didn't get the frames\n");
+        return -1;
+    }
+    return counted;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    struct Case
+    {
+        const char *name;
+        QTuioHandler::Options options;
+    };
+    Case cases[3];
+
+    cases[0].name = "recycleFrames";
+    cases[0].options.recycleFrames = true;
+
+    cases[1].name = "recycleFrames, filter";
+    cases[1].options.recycleFrames = true;
+    cases[1].options.filter.type = QTuioFilterParameters::OneEuroFilter;
+
+    cases[2].name = "recycleFrames, filter, mergeSources";
+    cases[2].options.recycleFrames = true;
+    cases[2].options.filter.type = QTuioFilterParameters::OneEuroFilter;
+    cases[2].options.mergeSources = true;
+
+    int failures = 0;
+    for (const Case &test : cases) {
+        const long count = countAllocations(test.options);
+        std::printf("%s %s: %ld allocations in %d frames\n", count ? "FAIL" : "PASS",
+                    test.name, count, int(CountedFrames));
+        if (count)
+            ++failures;
+    }
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# Checks that QTuioHandler releases the sessions of a tracker that went
+# quiet, and keeps those of one only sending redundant frames. Run it with
+# "make check".
+#
+#-------------------------------------------------
+
+QT       += core network
+
+TARGET = tst_expiry
+TEMPLATE = app
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../../sockets/src/companion-qt-sockets.pri)
+include(../../src/companion-qtuio.pri)
+include(../shared/shared.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,106 @@
+#include <QCoreApplication>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "qtuiohandler.h"
+#include "tuiobundlebuilder.h"
+
+// Replays a few frames of a tracker, then lets time pass the source timeout
+// the way the handler's expiry timer does, and checks which sessions were
+// released.
+
+namespace {
+
+const qint64 Millisecond = 1000000;
+const int SourceTimeout = 1000;
+
+// runs the expiry check for a given time, like the timer does for now
+class Handler : public QTuioHandler
+{
+public:
+    explicit Handler(const Options &options)
+        : QTuioHandler(QHostAddress::LocalHost, 0, options)
+    {
+    }
+
+    using QTuioHandler::expireSources;
+};
+
+QByteArray cursorFrame(qint32 fseq)
+{
+    BundleBuilder cursors("/tuio/2Dcur");
+    const int ids[] = { 1, 2 };
+    cursors.alive(ids, 2);
+    if (fseq != -1) {
+        cursors.setCursor(1, 0.25f, 0.5f + 0.001f * fseq);
+        cursors.setCursor(2, 0.75f, 0.5f);
+    }
+    cursors.fseq(fseq);
+    return cursors.bundle();
+}
+
+struct Result
+{
+    Result() : released(0), active(0) {}
+
+    int released;
+    int active;
+};
+
+// Sends 10 frames, then \a keepAliveFor ms of redundant frames (FSEQ -1),
+// and expires sources \a silentFor ms after the last datagram.
+Result run(bool mergeSources, int keepAliveFor, int silentFor)
+{
+    QTuioHandler::Options options;
+    options.sourceTimeout = SourceTimeout;
+    options.mergeSources = mergeSources;
+    Handler handler(options);
+
+    Result result;
+    QObject::connect(&handler, &QTuioHandler::cursorEvent,
+                     [&result](const QVector<QTuioCursor> &active, const QVector<QTuioCursor> &dead) {
+        result.active = active.size();
+        result.released += dead.size();
+    });
+
+    const QHostAddress sender(QHostAddress::LocalHost);
+    qint64 time = Q_INT64_C(1500000000000000000);
+    for (int fseq = 1; fseq <= 10; ++fseq, time += 20 * Millisecond) {
+        const QByteArray datagram = cursorFrame(fseq);
+        handler.processDatagram(datagram.constData(), datagram.size(), sender, 3333, time);
+    }
+    for (int t = 0; t < keepAliveFor; t += 100, time += 100 * Millisecond) {
+        const QByteArray datagram = cursorFrame(-1);
+        handler.processDatagram(datagram.constData(), datagram.size(), sender, 3333, time);
+    }
+
+    handler.expireSources(time + silentFor * Millisecond);
+    return result;
+}
+
+bool check(const char *name, const Result &result, int released, int active)
+{
+    const bool pass = result.released == released && result.active == active;
+    std::printf("%s %s: %d released, %d active (expected %d, %d)\n", pass ? "PASS" : "FAIL", name,
+                result.released, result.active, released, active);
+    return pass;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int failures = 0;
+    if (!check("silent tracker", run(false, 0, 2 * SourceTimeout), 2, 0))
+        ++failures;
+    if (!check("silent tracker, mergeSources", run(true, 0, 2 * SourceTimeout), 2, 0))
+        ++failures;
+    if (!check("before the timeout", run(false, 0, SourceTimeout / 2), 0, 2))
+        ++failures;
+    if (!check("redundant frames only", run(false, 5 * SourceTimeout, SourceTimeout / 2), 0, 2))
+        ++failures;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#ifndef TUIOBUNDLEBUILDER_H
+#define TUIOBUNDLEBUILDER_H
+
+#include <QByteArray>
+#include <QtEndian>
+
+#include <cstring>
+
+// Builds TUIO 1.1 bundles the way trackers send them: one profile per
+// bundle, with its SOURCE, ALIVE, SETs and FSEQ.
+
+inline void appendString(QByteArray &out, const char *string)
+{
+    const int size = int(std::strlen(string));
+    out.append(string, size);
+    for (int pad = 4 - size % 4; pad > 0; --pad)
+        out.append('\0');
+}
+
+inline void appendInt(QByteArray &out, qint32 value)
+{
+    char bytes[4];
+    qToBigEndian<quint32>(quint32(value), bytes);
+    out.append(bytes, 4);
+}
+
+inline void appendFloat(QByteArray &out, float value)
+{
+    quint32 bits;
+    std::memcpy(&bits, &value, 4);
+    appendInt(out, qint32(bits));
+}
+
+class BundleBuilder
+{
+public:
+    explicit BundleBuilder(const char *address) : m_address(address)
+    {
+        appendString(m_bundle, "#bundle");
+        appendInt(m_bundle, 0);
+        appendInt(m_bundle, 1);
+    }
+
+    // "name@address"
+    void source(const char *name)
+    {
+        QByteArray message = begin(",ss", "source");
+        appendString(message, name);
+        end(message);
+    }
+
+    void alive(const int *ids, int count)
+    {
+        QByteArray tags(",s");
+        for (int i = 0; i < count; ++i)
+            tags.append('i');
+        QByteArray message = begin(tags.constData(), "alive");
+        for (int i = 0; i < count; ++i)
+            appendInt(message, ids[i]);
+        end(message);
+    }
+
+    // /tuio/2Dcur set s x y X Y m
+    void setCursor(int id, float x, float y)
+    {
+        QByteArray message = begin(",sifffff", "set");
+        appendInt(message, id);
+        appendFloat(message, x);
+        appendFloat(message, y);
+        for (int i = 0; i < 3; ++i)
+            appendFloat(message, 0);
+        end(message);
+    }
+
+    // /tuio/2Dobj set s i x y a X Y A m r
+    void setToken(int id, int classId, float x, float y, float angle)
+    {
+        QByteArray message = begin(",siiffffffff", "set");
+        appendInt(message, id);
+        appendInt(message, classId);
+        appendFloat(message, x);
+        appendFloat(message, y);
+        appendFloat(message, angle);
+        for (int i = 0; i < 5; ++i)
+            appendFloat(message, 0);
+        end(message);
+    }
+
+    void fseq(int frame)
+    {
+        QByteArray message = begin(",si", "fseq");
+        appendInt(message, frame);
+        end(message);
+    }
+
+    QByteArray bundle() const { return m_bundle; }
+
+private:
+    QByteArray begin(const char *tags, const char *command) const
+    {
+        QByteArray message;
+        appendString(message, m_address);
+        appendString(message, tags);
+        appendString(message, command);
+        return message;
+    }
+
+    void end(const QByteArray &message)
+    {
+        appendInt(m_bundle, message.size());
+        m_bundle.append(message);
+    }
+
+    const char *m_address;
+    QByteArray m_bundle;
+};
+
+#endif // TUIOBUNDLEBUILDER_H
@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    expiry
+
+# counts allocations by replacing glibc's malloc
+linux: SUBDIRS += alloc